@@ -0,0 +1,34 @@
+#ifndef MATCHIT_BENCHMARK_H
+#define MATCHIT_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Best of a few runs, in nanoseconds per element.
+template <typename Func>
+double measure(std::string const &name, std::size_t size, Func const &func)
+{
+  constexpr int32_t kRUNS = 5;
+  auto best = std::chrono::nanoseconds::max();
+  for (int32_t i = 0; i < kRUNS; ++i)
+  {
+    auto const start = std::chrono::steady_clock::now();
+    func();
+    auto const stop = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start));
+  }
+  auto const perElement = static_cast<double>(best.count()) / static_cast<double>(size);
+  std::cout << name << ": " << perElement << " ns/element" << std::endl;
+  return perElement;
+}
+
+inline std::size_t sizeFromArgs(int32_t argc, char **argv, std::size_t defaultSize)
+{
+  return argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : defaultSize;
+}
+
+#endif // MATCHIT_BENCHMARK_H
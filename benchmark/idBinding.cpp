@@ -0,0 +1,64 @@
+#include "benchmark.h"
+#include "matchit.h"
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+using namespace matchit;
+
+// Bind a field through an Id and read it back in the handler, against reading
+// the same field through a raw pointer.
+
+int32_t main(int32_t argc, char **argv)
+{
+  auto const size = sizeFromArgs(argc, argv, 1'000'000);
+  auto values = std::vector<std::optional<std::string>>(size);
+  auto engine = std::mt19937{42};
+  auto dist = std::uniform_int_distribution<int32_t>{0, 3};
+  std::generate(values.begin(), values.end(),
+                [&]() -> std::optional<std::string>
+                {
+                  auto const n = dist(engine);
+                  if (n == 0)
+                  {
+                    return std::nullopt;
+                  }
+                  return std::string(static_cast<std::size_t>(n), 'x');
+                });
+
+  std::size_t bound = 0;
+  measure("bind and read via Id", size,
+          [&]
+          {
+            bound = 0;
+            for (auto const &v : values)
+            {
+              Id<std::string> s;
+              bound += match(v)(
+                  // clang-format off
+                  pattern | some(s) = [&] { return (*s).size(); },
+                  pattern | none    = expr(std::size_t{0})
+                  // clang-format on
+              );
+            }
+          });
+
+  std::size_t raw = 0;
+  measure("read via raw pointer", size,
+          [&]
+          {
+            raw = 0;
+            for (auto const &v : values)
+            {
+              std::string const *p = v ? &*v : nullptr;
+              raw += p != nullptr ? p->size() : 0;
+            }
+          });
+
+  if (bound != raw)
+  {
+    std::cerr << "results differ" << std::endl;
+    return 1;
+  }
+  return 0;
+}
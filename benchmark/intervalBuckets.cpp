@@ -0,0 +1,74 @@
+#include "benchmark.h"
+#include "matchit.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+using namespace matchit;
+
+// Hundreds of half-open buckets of a histogram, looked up through the table a
+// matcher builds once, against a hand-written binary search over the bounds.
+
+constexpr std::size_t kBUCKETS = 256;
+constexpr int32_t kWIDTH = 16;
+
+template <std::size_t... I>
+constexpr auto bucketMatcher(std::index_sequence<I...>)
+{
+  return matcher(pattern | (static_cast<int32_t>(I) * kWIDTH <= _ &&
+                            _ < static_cast<int32_t>(I + 1) * kWIDTH) =
+                     expr(static_cast<int32_t>(I))...,
+                 pattern | _ = expr(-1));
+}
+
+int32_t bucketSearch(int32_t value)
+{
+  static auto const lows = []
+  {
+    std::array<int32_t, kBUCKETS + 1> result{};
+    for (std::size_t i = 0; i <= kBUCKETS; ++i)
+    {
+      result[i] = static_cast<int32_t>(i) * kWIDTH;
+    }
+    return result;
+  }();
+  if (value < lows.front() || value >= lows.back())
+  {
+    return -1;
+  }
+  auto const it = std::upper_bound(lows.begin(), lows.end(), value);
+  return static_cast<int32_t>(it - lows.begin()) - 1;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+  auto const size = sizeFromArgs(argc, argv, 10'000'000);
+  auto values = std::vector<int32_t>(1024);
+  std::uint32_t seed = 1;
+  for (auto &value : values)
+  {
+    seed = seed * 1664525U + 1013904223U;
+    value = static_cast<int32_t>(seed % (kBUCKETS * kWIDTH + 64U)) - 32;
+  }
+  auto const bucket = bucketMatcher(std::make_index_sequence<kBUCKETS>{});
+
+  int64_t results[2] = {};
+  auto const run = [&](auto const &func)
+  {
+    int64_t total = 0;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      total += func(values[i % values.size()]);
+    }
+    return total;
+  };
+  measure("matchit matcher", size, [&] { results[0] = run(bucket); });
+  measure("binary search", size, [&] { results[1] = run(bucketSearch); });
+  if (results[0] != results[1])
+  {
+    std::cerr << "wrong result" << std::endl;
+    return 1;
+  }
+  return 0;
+}
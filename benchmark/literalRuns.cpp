@@ -0,0 +1,56 @@
+#include "benchmark.h"
+#include "matchit.h"
+#include <cstdint>
+#include <vector>
+using namespace matchit;
+
+// Check the magic header and trailer of 4k byte buffers with
+// ds(0x7f, 'E', 'L', 'F', ..., ooo, ...).
+
+int32_t kind(std::vector<uint8_t> const &buffer)
+{
+  return match(buffer)(
+      // clang-format off
+      pattern | ds(0x7f, 'E', 'L', 'F', 2, 1, 1, 0, ooo, 'E', 'N', 'D')  = expr(64),
+      pattern | ds(0x7f, 'E', 'L', 'F', 1, 1, 1, 0, ooo, 'E', 'N', 'D')  = expr(32),
+      pattern | _                                                         = expr(0)
+      // clang-format on
+  );
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+  auto const size = sizeFromArgs(argc, argv, 1'000'000);
+  auto buffers = std::vector<std::vector<uint8_t>>(64, std::vector<uint8_t>(4096));
+  for (std::size_t i = 0; i < buffers.size(); ++i)
+  {
+    auto &buffer = buffers[i];
+    uint8_t const header[] = {0x7f, 'E', 'L', 'F', static_cast<uint8_t>(1 + i % 2), 1, 1, 0};
+    std::copy(std::begin(header), std::end(header), buffer.begin());
+    uint8_t const trailer[] = {'E', 'N', static_cast<uint8_t>(i % 3 == 0 ? 'X' : 'D')};
+    std::copy(std::begin(trailer), std::end(trailer), buffer.end() - 3);
+  }
+
+  int64_t total = 0;
+  measure("magic", size,
+          [&]
+          {
+            total = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+              total += kind(buffers[i % buffers.size()]);
+            }
+          });
+  int64_t expected = 0;
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    auto const j = i % buffers.size();
+    expected += j % 3 == 0 ? 0 : (j % 2 == 0 ? 32 : 64);
+  }
+  if (total != expected)
+  {
+    std::cerr << "wrong result" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include "benchmark.h"
+#include "matchit.h"
+#include <numeric>
+#include <random>
+#include <vector>
+using namespace matchit;
+
+// Classify telemetry values into buckets: a hand-written loop, a match per
+// element, and matchAll.
+
+int32_t bucketOf(int32_t value)
+{
+  return match(value)(
+      // clang-format off
+      pattern | (_ < 0)                 = expr(0),
+      pattern | (0    <= _ && _ < 10)   = expr(1),
+      pattern | (10   <= _ && _ < 50)   = expr(2),
+      pattern | (50   <= _ && _ < 100)  = expr(3),
+      pattern | (100  <= _ && _ < 500)  = expr(4),
+      pattern | (500  <= _ && _ < 1000) = expr(5),
+      pattern | (1000 <= _ && _ < 5000) = expr(6),
+      pattern | _                       = expr(7)
+      // clang-format on
+  );
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+  auto const size = sizeFromArgs(argc, argv, 10'000'000);
+  auto values = std::vector<int32_t>(size);
+  auto engine = std::mt19937{42};
+  auto dist = std::uniform_int_distribution<int32_t>{-100, 10000};
+  std::generate(values.begin(), values.end(), [&] { return dist(engine); });
+  auto results = std::vector<int32_t>(size);
+
+  measure("hand-written loop", size,
+          [&]
+          {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+              auto const v = values[i];
+              results[i] = v < 0      ? 0
+                           : v < 10   ? 1
+                           : v < 50   ? 2
+                           : v < 100  ? 3
+                           : v < 500  ? 4
+                           : v < 1000 ? 5
+                           : v < 5000 ? 6
+                                      : 7;
+            }
+          });
+  auto const expected = std::accumulate(results.begin(), results.end(), int64_t{0});
+
+  measure("match per element", size,
+          [&]
+          {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+              results[i] = bucketOf(values[i]);
+            }
+          });
+  auto const perElement = std::accumulate(results.begin(), results.end(), int64_t{0});
+
+  measure("matchAll", size,
+          [&]
+          {
+            matchAll(values, results.begin(),
+                     // clang-format off
+                     pattern | (_ < 0)                 = expr(0),
+                     pattern | (0    <= _ && _ < 10)   = expr(1),
+                     pattern | (10   <= _ && _ < 50)   = expr(2),
+                     pattern | (50   <= _ && _ < 100)  = expr(3),
+                     pattern | (100  <= _ && _ < 500)  = expr(4),
+                     pattern | (500  <= _ && _ < 1000) = expr(5),
+                     pattern | (1000 <= _ && _ < 5000) = expr(6),
+                     pattern | _                       = expr(7)
+                     // clang-format on
+            );
+          });
+  auto const batched = std::accumulate(results.begin(), results.end(), int64_t{0});
+
+  if (perElement != expected || batched != expected)
+  {
+    std::cerr << "results differ" << std::endl;
+    return 1;
+  }
+  return 0;
+}
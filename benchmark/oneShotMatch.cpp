@@ -0,0 +1,407 @@
+#include "benchmark.h"
+#include "matchit.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+using namespace matchit;
+
+// One match per call, so that whatever is done for the table of the arms is
+// measured too. Literals, sixty opcodes, intervals and strings against
+// hand-written code.
+
+int32_t literal(int32_t code)
+{
+  return match(code)(
+      // clang-format off
+      pattern | 100 = expr(1),
+      pattern | 200 = expr(2),
+      pattern | 201 = expr(3),
+      pattern | 204 = expr(4),
+      pattern | 301 = expr(5),
+      pattern | 302 = expr(6),
+      pattern | 304 = expr(7),
+      pattern | 400 = expr(8),
+      pattern | 401 = expr(9),
+      pattern | 403 = expr(10),
+      pattern | 404 = expr(11),
+      pattern | 500 = expr(12),
+      pattern | _   = expr(0)
+      // clang-format on
+  );
+}
+
+int32_t literalSwitch(int32_t code)
+{
+  switch (code)
+  {
+  case 100:
+    return 1;
+  case 200:
+    return 2;
+  case 201:
+    return 3;
+  case 204:
+    return 4;
+  case 301:
+    return 5;
+  case 302:
+    return 6;
+  case 304:
+    return 7;
+  case 400:
+    return 8;
+  case 401:
+    return 9;
+  case 403:
+    return 10;
+  case 404:
+    return 11;
+  case 500:
+    return 12;
+  default:
+    return 0;
+  }
+}
+
+int32_t opcode(int32_t op)
+{
+  return match(op)(
+      // clang-format off
+      pattern | 16  = expr(1),
+      pattern | 18  = expr(2),
+      pattern | 20  = expr(3),
+      pattern | 22  = expr(4),
+      pattern | 24  = expr(5),
+      pattern | 26  = expr(6),
+      pattern | 28  = expr(7),
+      pattern | 30  = expr(8),
+      pattern | 32  = expr(9),
+      pattern | 34  = expr(10),
+      pattern | 36  = expr(11),
+      pattern | 38  = expr(12),
+      pattern | 40  = expr(13),
+      pattern | 42  = expr(14),
+      pattern | 44  = expr(15),
+      pattern | 46  = expr(16),
+      pattern | 48  = expr(17),
+      pattern | 50  = expr(18),
+      pattern | 52  = expr(19),
+      pattern | 54  = expr(20),
+      pattern | 57  = expr(21),
+      pattern | 59  = expr(22),
+      pattern | 61  = expr(23),
+      pattern | 63  = expr(24),
+      pattern | 65  = expr(25),
+      pattern | 67  = expr(26),
+      pattern | 69  = expr(27),
+      pattern | 71  = expr(28),
+      pattern | 73  = expr(29),
+      pattern | 75  = expr(30),
+      pattern | 77  = expr(31),
+      pattern | 79  = expr(32),
+      pattern | 81  = expr(33),
+      pattern | 83  = expr(34),
+      pattern | 85  = expr(35),
+      pattern | 87  = expr(36),
+      pattern | 89  = expr(37),
+      pattern | 91  = expr(38),
+      pattern | 93  = expr(39),
+      pattern | 95  = expr(40),
+      pattern | 98  = expr(41),
+      pattern | 100 = expr(42),
+      pattern | 102 = expr(43),
+      pattern | 104 = expr(44),
+      pattern | 106 = expr(45),
+      pattern | 108 = expr(46),
+      pattern | 110 = expr(47),
+      pattern | 112 = expr(48),
+      pattern | 114 = expr(49),
+      pattern | 116 = expr(50),
+      pattern | 118 = expr(51),
+      pattern | 120 = expr(52),
+      pattern | 122 = expr(53),
+      pattern | 124 = expr(54),
+      pattern | 126 = expr(55),
+      pattern | 128 = expr(56),
+      pattern | 130 = expr(57),
+      pattern | 132 = expr(58),
+      pattern | 134 = expr(59),
+      pattern | 136 = expr(60),
+      pattern | _   = expr(0)
+      // clang-format on
+  );
+}
+
+int32_t opcodeSwitch(int32_t op)
+{
+  switch (op)
+  {
+  case 16:
+    return 1;
+  case 18:
+    return 2;
+  case 20:
+    return 3;
+  case 22:
+    return 4;
+  case 24:
+    return 5;
+  case 26:
+    return 6;
+  case 28:
+    return 7;
+  case 30:
+    return 8;
+  case 32:
+    return 9;
+  case 34:
+    return 10;
+  case 36:
+    return 11;
+  case 38:
+    return 12;
+  case 40:
+    return 13;
+  case 42:
+    return 14;
+  case 44:
+    return 15;
+  case 46:
+    return 16;
+  case 48:
+    return 17;
+  case 50:
+    return 18;
+  case 52:
+    return 19;
+  case 54:
+    return 20;
+  case 57:
+    return 21;
+  case 59:
+    return 22;
+  case 61:
+    return 23;
+  case 63:
+    return 24;
+  case 65:
+    return 25;
+  case 67:
+    return 26;
+  case 69:
+    return 27;
+  case 71:
+    return 28;
+  case 73:
+    return 29;
+  case 75:
+    return 30;
+  case 77:
+    return 31;
+  case 79:
+    return 32;
+  case 81:
+    return 33;
+  case 83:
+    return 34;
+  case 85:
+    return 35;
+  case 87:
+    return 36;
+  case 89:
+    return 37;
+  case 91:
+    return 38;
+  case 93:
+    return 39;
+  case 95:
+    return 40;
+  case 98:
+    return 41;
+  case 100:
+    return 42;
+  case 102:
+    return 43;
+  case 104:
+    return 44;
+  case 106:
+    return 45;
+  case 108:
+    return 46;
+  case 110:
+    return 47;
+  case 112:
+    return 48;
+  case 114:
+    return 49;
+  case 116:
+    return 50;
+  case 118:
+    return 51;
+  case 120:
+    return 52;
+  case 122:
+    return 53;
+  case 124:
+    return 54;
+  case 126:
+    return 55;
+  case 128:
+    return 56;
+  case 130:
+    return 57;
+  case 132:
+    return 58;
+  case 134:
+    return 59;
+  case 136:
+    return 60;
+  default:
+    return 0;
+  }
+}
+
+int32_t interval(int32_t value)
+{
+  return match(value)(
+      // clang-format off
+      pattern | (_ < 0)                = expr(0),
+      pattern | (0 <= _ && _ < 10)     = expr(1),
+      pattern | (10 <= _ && _ < 100)   = expr(2),
+      pattern | (100 <= _ && _ < 200)  = expr(3),
+      pattern | (200 <= _ && _ < 400)  = expr(4),
+      pattern | (400 <= _ && _ < 800)  = expr(5),
+      pattern | (800 <= _ && _ < 1000) = expr(6),
+      pattern | _                      = expr(7)
+      // clang-format on
+  );
+}
+
+int32_t intervalIfs(int32_t value)
+{
+  if (value < 0)
+  {
+    return 0;
+  }
+  if (value < 10)
+  {
+    return 1;
+  }
+  if (value < 100)
+  {
+    return 2;
+  }
+  if (value < 200)
+  {
+    return 3;
+  }
+  if (value < 400)
+  {
+    return 4;
+  }
+  if (value < 800)
+  {
+    return 5;
+  }
+  if (value < 1000)
+  {
+    return 6;
+  }
+  return 7;
+}
+
+int32_t command(std::string_view cmd)
+{
+  return match(cmd)(
+      // clang-format off
+      pattern | "GET"     = expr(1),
+      pattern | "PUT"     = expr(2),
+      pattern | "POST"    = expr(3),
+      pattern | "HEAD"    = expr(4),
+      pattern | "PATCH"   = expr(5),
+      pattern | "TRACE"   = expr(6),
+      pattern | "DELETE"  = expr(7),
+      pattern | "OPTIONS" = expr(8),
+      pattern | _         = expr(0)
+      // clang-format on
+  );
+}
+
+int32_t commandIfs(std::string_view cmd)
+{
+  if (cmd == "GET")
+  {
+    return 1;
+  }
+  if (cmd == "PUT")
+  {
+    return 2;
+  }
+  if (cmd == "POST")
+  {
+    return 3;
+  }
+  if (cmd == "HEAD")
+  {
+    return 4;
+  }
+  if (cmd == "PATCH")
+  {
+    return 5;
+  }
+  if (cmd == "TRACE")
+  {
+    return 6;
+  }
+  if (cmd == "DELETE")
+  {
+    return 7;
+  }
+  if (cmd == "OPTIONS")
+  {
+    return 8;
+  }
+  return 0;
+}
+
+template <typename T, typename Func>
+int64_t run(std::vector<T> const &inputs, std::size_t size, Func const &func)
+{
+  int64_t total = 0;
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    total += func(inputs[i % inputs.size()]);
+  }
+  return total;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+  auto const size = sizeFromArgs(argc, argv, 10'000'000);
+  auto const codes = std::vector<int32_t>{200, 404, 500, 301, 100, 403, 999, 204, 302, 401};
+  auto opcodes = std::vector<int32_t>{};
+  for (int32_t op = 0; op < 160; op += 7)
+  {
+    opcodes.push_back(op);
+  }
+  auto const values = std::vector<int32_t>{-5, 3, 42, 150, 399, 512, 999, 4096, 0, 77};
+  auto const commands = std::vector<std::string_view>{"GET", "POST", "DELETE", "CONNECT",
+                                                      "PUT", "HEAD", "OPTIONS", "TRACE"};
+
+  int64_t results[8] = {};
+  measure("matchit literals", size, [&] { results[0] = run(codes, size, literal); });
+  measure("switch", size, [&] { results[1] = run(codes, size, literalSwitch); });
+  measure("matchit opcodes", size, [&] { results[6] = run(opcodes, size, opcode); });
+  measure("opcode switch", size, [&] { results[7] = run(opcodes, size, opcodeSwitch); });
+  measure("matchit intervals", size, [&] { results[2] = run(values, size, interval); });
+  measure("if chain", size, [&] { results[3] = run(values, size, intervalIfs); });
+  measure("matchit strings", size, [&] { results[4] = run(commands, size, command); });
+  measure("string compares", size, [&] { results[5] = run(commands, size, commandIfs); });
+  if (results[0] != results[1] || results[2] != results[3] || results[4] != results[5] ||
+      results[6] != results[7])
+  {
+    std::cerr << "wrong result" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,57 @@
+#include "benchmark.h"
+#include "matchit.h"
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+using namespace matchit;
+
+// Throughput of parallelMatchAll from one thread to all cores. Every worker
+// binds into its own Id.
+
+auto makeClassifier()
+{
+  return matcher<Id<int32_t>>(
+      [](Id<int32_t, PerCall<>> &x)
+      {
+        return matcher(
+            // clang-format off
+            pattern | (_ < 0)                     = expr(-1),
+            pattern | x.at(0 <= _ && _ < 100)     = [&x] { return *x / 10; },
+            pattern | x.at(100 <= _ && _ < 5000)  = [&x] { return 10 + *x / 500; },
+            pattern | _                           = expr(20)
+            // clang-format on
+        );
+      });
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+  auto const size = sizeFromArgs(argc, argv, 10'000'000);
+  auto values = std::vector<int32_t>(size);
+  auto engine = std::mt19937{42};
+  auto dist = std::uniform_int_distribution<int32_t>{-100, 10000};
+  std::generate(values.begin(), values.end(), [&] { return dist(engine); });
+  auto results = std::vector<int32_t>(size);
+
+  measure("matchAll", size, [&] { makeClassifier().all(values, results.begin()); });
+  auto const expected = std::accumulate(results.begin(), results.end(), int64_t{0});
+
+  auto const nbCores = std::max(1U, std::thread::hardware_concurrency());
+  for (auto nbThreads = 1U;; nbThreads = std::min(2 * nbThreads, nbCores))
+  {
+    std::fill(results.begin(), results.end(), 0);
+    measure("parallelMatchAll, " + std::to_string(nbThreads) + " threads", size,
+            [&] { parallelMatchAll(values, results.begin(), makeClassifier, nbThreads); });
+    if (std::accumulate(results.begin(), results.end(), int64_t{0}) != expected)
+    {
+      std::cerr << "results differ" << std::endl;
+      return 1;
+    }
+    if (nbThreads == nbCores)
+    {
+      break;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,61 @@
+#include "benchmark.h"
+#include "matchit.h"
+#include <deque>
+#include <list>
+#include <numeric>
+#include <set>
+#include <vector>
+using namespace matchit;
+
+// Destructure the first, the last and the middle of 10k element ranges with
+// ds(..., ooo, ...), on list, set and deque.
+
+template <typename Range>
+int64_t firstMiddleLast(Range const &range)
+{
+  using T = typename Range::value_type;
+  Id<T> first, second, last;
+  Id<SubrangeT<Range const>> middle;
+  return match(range)(
+      // clang-format off
+      pattern | ds(first, second, middle.at(ooo), last) = [&] { return *first + *second + *last + static_cast<int64_t>((*middle).size()); },
+      pattern | _                                       = expr(int64_t{-1})
+      // clang-format on
+  );
+}
+
+template <typename Range>
+bool measureRange(char const *name, Range const &range, std::size_t rounds)
+{
+  int64_t total = 0;
+  measure(name, rounds,
+          [&]
+          {
+            total = 0;
+            for (std::size_t i = 0; i < rounds; ++i)
+            {
+              total += firstMiddleLast(range);
+            }
+          });
+  auto const n = static_cast<int64_t>(range.size());
+  return total == static_cast<int64_t>(rounds) * (0 + 1 + (n - 1) + (n - 3));
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+  auto const rounds = sizeFromArgs(argc, argv, 100'000);
+  auto values = std::vector<int32_t>(10'000);
+  std::iota(values.begin(), values.end(), 0);
+  auto const list = std::list<int32_t>(values.begin(), values.end());
+  auto const set = std::set<int32_t>(values.begin(), values.end());
+  auto const deque = std::deque<int32_t>(values.begin(), values.end());
+
+  auto const ok = measureRange("list", list, rounds) && measureRange("set", set, rounds) &&
+                  measureRange("deque", deque, rounds);
+  if (!ok)
+  {
+    std::cerr << "wrong result" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include "benchmark.h"
+#include "matchit.h"
+#include <cstdint>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace matchit;
+
+// Parse "key=value" lines with regex("([a-z_]+)=(\\d+)") and with std::regex.
+
+constexpr auto kKeyValue = regex("([a-z_]+)=(\\d+)");
+
+std::size_t parse(std::string const &line)
+{
+  Id<std::string_view> key, value;
+  return match(line)(
+      // clang-format off
+      pattern | kKeyValue(key, value) = [&] { return (*key).size() + (*value).size(); },
+      pattern | kKeyValue()           = expr(std::size_t{1}),
+      pattern | _                     = expr(std::size_t{0})
+      // clang-format on
+  );
+}
+
+std::size_t parseStd(std::regex const &keyValue, std::string const &line)
+{
+  std::smatch groups;
+  if (std::regex_match(line, groups, keyValue))
+  {
+    return static_cast<std::size_t>(groups.length(1) + groups.length(2));
+  }
+  return 0;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+  auto const size = sizeFromArgs(argc, argv, 1'000'000);
+  auto const lines =
+      std::vector<std::string>{"max_conn=128", "timeout=30", "name=x", "port=8080", "retries=three"};
+
+  std::size_t total = 0;
+  measure("matchit regex", size,
+          [&]
+          {
+            total = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+              total += parse(lines[i % lines.size()]);
+            }
+          });
+  auto const keyValue = std::regex{"([a-z_]+)=(\\d+)"};
+  std::size_t expected = 0;
+  measure("std::regex", size,
+          [&]
+          {
+            expected = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+              expected += parseStd(keyValue, lines[i % lines.size()]);
+            }
+          });
+  if (total != expected)
+  {
+    std::cerr << "wrong result" << std::endl;
+    return 1;
+  }
+  return 0;
+}
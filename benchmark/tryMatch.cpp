@@ -0,0 +1,67 @@
+#include "benchmark.h"
+#include "matchit.h"
+#include <random>
+#include <stdexcept>
+#include <vector>
+using namespace matchit;
+
+// Parse opcodes where half of the input is unknown: match inside try/catch
+// against tryMatch.
+
+int32_t main(int32_t argc, char **argv)
+{
+  auto const size = sizeFromArgs(argc, argv, 1'000'000);
+  auto values = std::vector<int32_t>(size);
+  auto engine = std::mt19937{42};
+  auto dist = std::uniform_int_distribution<int32_t>{0, 15};
+  std::generate(values.begin(), values.end(), [&] { return dist(engine); });
+
+  int64_t caught = 0;
+  measure("match with try/catch", size,
+          [&]
+          {
+            caught = 0;
+            for (auto const v : values)
+            {
+              try
+              {
+                caught += match(v)(
+                    // clang-format off
+                    pattern | 1                     = expr(10),
+                    pattern | 3                     = expr(30),
+                    pattern | (_ % 2 == 0 && _ < 8) = expr(1)
+                    // clang-format on
+                );
+              }
+              catch (std::logic_error const &)
+              {
+                caught -= 1;
+              }
+            }
+          });
+
+  int64_t tried = 0;
+  measure("tryMatch", size,
+          [&]
+          {
+            tried = 0;
+            for (auto const v : values)
+            {
+              tried += tryMatch(v)(
+                           // clang-format off
+                           pattern | 1                     = expr(10),
+                           pattern | 3                     = expr(30),
+                           pattern | (_ % 2 == 0 && _ < 8) = expr(1)
+                           // clang-format on
+                           )
+                           .value_or(-1);
+            }
+          });
+
+  if (caught != tried)
+  {
+    std::cerr << "results differ" << std::endl;
+    return 1;
+  }
+  return 0;
+}
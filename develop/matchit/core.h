@@ -2,13 +2,172 @@
 #define MATCHIT_CORE_H
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#ifdef MATCHIT_STATS
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MATCHIT_EXPECT(cond, expected) __builtin_expect(static_cast<long>(cond), expected)
+#define MATCHIT_COLD __attribute__((cold, noinline))
+#define MATCHIT_NOINLINE __attribute__((noinline))
+#define MATCHIT_KNOWN(value) __builtin_constant_p(value)
+#define MATCHIT_INLINE __attribute__((always_inline)) inline
+#elif defined(_MSC_VER)
+#define MATCHIT_EXPECT(cond, expected) (cond)
+#define MATCHIT_COLD __declspec(noinline)
+#define MATCHIT_NOINLINE __declspec(noinline)
+#define MATCHIT_KNOWN(value) false
+#define MATCHIT_INLINE __forceinline
+#else
+#define MATCHIT_EXPECT(cond, expected) (cond)
+#define MATCHIT_COLD
+#define MATCHIT_NOINLINE
+#define MATCHIT_KNOWN(value) false
+#define MATCHIT_INLINE inline
+#endif
 
 namespace matchit
 {
     namespace impl
     {
+        // Set with pattern.likely | ... and pattern.cold | ...
+        enum class Hint : int32_t
+        {
+            kNONE,
+            kLIKELY,
+            kCOLD
+        };
+
+        template <Hint hint>
+        constexpr bool expect(bool cond)
+        {
+            if constexpr (hint == Hint::kLIKELY)
+            {
+                return MATCHIT_EXPECT(cond, 1);
+            }
+            else if constexpr (hint == Hint::kCOLD)
+            {
+                return MATCHIT_EXPECT(cond, 0);
+            }
+            else
+            {
+                return cond;
+            }
+        }
+
+#ifdef MATCHIT_STATS
+        // Counters of one arm, updated with relaxed atomics.
+        class ArmStats
+        {
+        public:
+            std::atomic<std::uint64_t> mAttempts{};
+            std::atomic<std::uint64_t> mHits{};
+            std::atomic<std::uint64_t> mFailures{};
+        };
+
+        class MatchSite;
+
+        class SiteRegistry
+        {
+        public:
+            std::mutex mMutex;
+            std::vector<MatchSite const *> mSites;
+        };
+
+        inline SiteRegistry &siteRegistry()
+        {
+            static SiteRegistry registry;
+            return registry;
+        }
+
+        // A named match, see match(value).at(site). Registers itself so that
+        // dumpMatchStats can report it.
+        class MatchSite
+        {
+        public:
+            explicit MatchSite(char const *name) : mName{name}
+            {
+                auto &registry = siteRegistry();
+                std::lock_guard<std::mutex> lock{registry.mMutex};
+                registry.mSites.push_back(this);
+            }
+            ~MatchSite()
+            {
+                auto &registry = siteRegistry();
+                std::lock_guard<std::mutex> lock{registry.mMutex};
+                registry.mSites.erase(
+                    std::find(registry.mSites.begin(), registry.mSites.end(), this));
+            }
+            MatchSite(MatchSite const &) = delete;
+            MatchSite &operator=(MatchSite const &) = delete;
+
+            // The counters are sized by the first match run at the site.
+            void call(std::size_t nbArms)
+            {
+                std::call_once(mArmsOnce, [this, nbArms]
+                               {
+                                   mArms = std::make_unique<ArmStats[]>(nbArms);
+                                   mNbArms.store(nbArms, std::memory_order_release);
+                               });
+                mCalls.fetch_add(1, std::memory_order_relaxed);
+            }
+            ArmStats &arm(std::size_t i) { return mArms[i]; }
+            ArmStats const &arm(std::size_t i) const { return mArms[i]; }
+            // None for the arms past those of the first match.
+            ArmStats *counters(std::size_t i) { return i < nbArms() ? &mArms[i] : nullptr; }
+            char const *name() const { return mName; }
+            std::uint64_t calls() const { return mCalls.load(std::memory_order_relaxed); }
+            std::size_t nbArms() const { return mNbArms.load(std::memory_order_acquire); }
+
+        private:
+            char const *mName;
+            std::atomic<std::uint64_t> mCalls{};
+            std::once_flag mArmsOnce;
+            std::unique_ptr<ArmStats[]> mArms;
+            std::atomic<std::size_t> mNbArms{};
+        };
+
+        // Print the counters of all live match sites.
+        template <typename Stream>
+        void dumpMatchStats(Stream &stream)
+        {
+            auto &registry = siteRegistry();
+            std::lock_guard<std::mutex> lock{registry.mMutex};
+            for (auto const *site : registry.mSites)
+            {
+                stream << "match site " << site->name() << ": " << site->calls() << " calls\n";
+                for (std::size_t i = 0; i < site->nbArms(); ++i)
+                {
+                    auto const &arm = site->arm(i);
+                    stream << "  arm " << i << ": "
+                           << arm.mAttempts.load(std::memory_order_relaxed) << " attempts, "
+                           << arm.mHits.load(std::memory_order_relaxed) << " hits, "
+                           << arm.mFailures.load(std::memory_order_relaxed) << " failures\n";
+                }
+            }
+        }
+#else
+        // Without MATCHIT_STATS, sites are empty and cost nothing.
+        class MatchSite
+        {
+        public:
+            constexpr explicit MatchSite(char const * /*name*/) {}
+        };
+
+        template <typename Stream>
+        void dumpMatchStats(Stream & /*stream*/)
+        {
+        }
+#endif
+
         template <typename Value, bool byRef>
         class ValueType
         {
@@ -26,6 +185,70 @@ namespace matchit
         template <typename Value, typename... Patterns>
         constexpr auto matchPatterns(Value &&value, Patterns const &...patterns);
 
+        template <typename Idx, typename... Arms>
+        class ArmSlots;
+
+        template <typename Value, typename Site, std::size_t... I, typename... Arms>
+        constexpr auto rematchPatterns(Value &&value, Site const &site,
+                                       ArmSlots<std::index_sequence<I...>, Arms...> const &arms);
+
+        template <typename... PatternPairs>
+        constexpr auto siteTable(PatternPairs const &...patterns);
+
+        template <typename Pattern, typename Func, Hint hint = Hint::kNONE>
+        class PatternPair;
+
+        class AdaptiveOrder;
+
+        template <typename Value, typename... PatternPairs>
+        auto matchAdaptive(AdaptiveOrder &order, Value &&value, PatternPairs const &...patterns);
+
+        template <typename Value, typename... PatternPairs>
+        auto tryMatchAdaptive(AdaptiveOrder &order, Value &&value,
+                              PatternPairs const &...patterns);
+
+        // tryOnly for tryMatch(value).adaptive(order).
+        template <typename Value, bool byRef, bool tryOnly = false>
+        class AdaptiveMatchHelper
+        {
+        private:
+            using ValueT = typename ValueType<Value, byRef>::ValueT;
+            ValueT mValue;
+            AdaptiveOrder &mOrder;
+            using ValueRefT = ValueT &&;
+
+        public:
+            template <typename V>
+            AdaptiveMatchHelper(V &&value, AdaptiveOrder &order)
+                : mValue{std::forward<V>(value)}, mOrder{order} {}
+            template <typename... PatternPair>
+            auto operator()(PatternPair const &...patterns)
+            {
+                if constexpr (tryOnly)
+                {
+                    return tryMatchAdaptive(mOrder, std::forward<ValueRefT>(mValue), patterns...);
+                }
+                else
+                {
+                    return matchAdaptive(mOrder, std::forward<ValueRefT>(mValue), patterns...);
+                }
+            }
+        };
+
+#ifdef MATCHIT_STATS
+        // Runs match(arms...) with the arms counting at site.
+        template <typename Match, std::size_t... I, typename... Patterns, typename... Funcs,
+                  Hint... hints>
+        auto matchAtSite(MatchSite &site, Match const &match, std::index_sequence<I...>,
+                         PatternPair<Patterns, Funcs, hints> const &...patterns)
+        {
+            site.call(sizeof...(I));
+            return match(PatternPair<Patterns, Funcs, hints>{patterns.pattern(),
+                                                             patterns.handler(),
+                                                             site.counters(I)}...);
+        }
+#endif
+
         template <typename Value, bool byRef>
         class MatchHelper
         {
@@ -40,8 +263,37 @@ namespace matchit
             template <typename... PatternPair>
             constexpr auto operator()(PatternPair const &...patterns)
             {
+#ifdef MATCHIT_STATS
+                if (mSite != nullptr)
+                {
+                    return matchAtSite(
+                        *mSite, [this](auto const &...arms)
+                        { return matchPatterns(std::forward<ValueRefT>(mValue), arms...); },
+                        std::index_sequence_for<PatternPair...>{}, patterns...);
+                }
+#endif
                 return matchPatterns(std::forward<ValueRefT>(mValue), patterns...);
             }
+            // Try the disjoint arms in the order of their recent hits.
+            auto adaptive(AdaptiveOrder &order)
+            {
+                return AdaptiveMatchHelper<Value, byRef>{std::forward<ValueRefT>(mValue), order};
+            }
+            // Count attempts and hits of each arm at site, with MATCHIT_STATS.
+            constexpr MatchHelper &at(MatchSite &site)
+            {
+#ifdef MATCHIT_STATS
+                mSite = &site;
+#else
+                static_cast<void>(site);
+#endif
+                return *this;
+            }
+
+#ifdef MATCHIT_STATS
+        private:
+            MatchSite *mSite = nullptr;
+#endif
         };
 
         template <typename Value>
@@ -58,10 +310,292 @@ namespace matchit
             return MatchHelper<decltype(result), false>{
                 std::forward<decltype(result)>(result)};
         }
+
+        template <typename Value, typename... Patterns>
+        constexpr auto tryMatchPatterns(Value &&value, Patterns const &...patterns);
+
+        template <typename Value, bool byRef>
+        class TryMatchHelper
+        {
+        private:
+            using ValueT = typename ValueType<Value, byRef>::ValueT;
+            ValueT mValue;
+            using ValueRefT = ValueT &&;
+
+        public:
+            template <typename V>
+            constexpr explicit TryMatchHelper(V &&value) : mValue{std::forward<V>(value)} {}
+            template <typename... PatternPair>
+            constexpr auto operator()(PatternPair const &...patterns)
+            {
+#ifdef MATCHIT_STATS
+                if (mSite != nullptr)
+                {
+                    return matchAtSite(
+                        *mSite, [this](auto const &...arms)
+                        { return tryMatchPatterns(std::forward<ValueRefT>(mValue), arms...); },
+                        std::index_sequence_for<PatternPair...>{}, patterns...);
+                }
+#endif
+                return tryMatchPatterns(std::forward<ValueRefT>(mValue), patterns...);
+            }
+            // Try the disjoint arms in the order of their recent hits.
+            auto adaptive(AdaptiveOrder &order)
+            {
+                return AdaptiveMatchHelper<Value, byRef, true>{std::forward<ValueRefT>(mValue),
+                                                               order};
+            }
+            // Count attempts and hits of each arm at site, with MATCHIT_STATS.
+            constexpr TryMatchHelper &at(MatchSite &site)
+            {
+#ifdef MATCHIT_STATS
+                mSite = &site;
+#else
+                static_cast<void>(site);
+#endif
+                return *this;
+            }
+
+#ifdef MATCHIT_STATS
+        private:
+            MatchSite *mSite = nullptr;
+#endif
+        };
+
+        // Like match, but never throws: expressions return an empty std::optional
+        // and statements false when no pattern matches.
+        template <typename Value>
+        constexpr auto tryMatch(Value &&value)
+        {
+            return TryMatchHelper<Value, true>{std::forward<Value>(value)};
+        }
+
+        template <typename First, typename... Values>
+        constexpr auto tryMatch(First &&first, Values &&...values)
+        {
+            auto result = std::forward_as_tuple(std::forward<First>(first),
+                                                std::forward<Values>(values)...);
+            return TryMatchHelper<decltype(result), false>{
+                std::forward<decltype(result)>(result)};
+        }
+
+        // Owns the pattern and the handler of an arm.
+        template <typename Pattern, typename Func, Hint hint>
+        class Arm
+        {
+        public:
+            constexpr explicit Arm(PatternPair<Pattern, Func, hint> const &pair)
+                : mPattern{pair.pattern()}, mHandler{pair.handler()} {}
+            constexpr auto pair() const
+            {
+                return PatternPair<Pattern, Func, hint>{mPattern, mHandler};
+            }
+
+        private:
+            Pattern const mPattern;
+            Func const mHandler;
+        };
+
+        template <typename Pattern, typename Func, Hint hint>
+        constexpr auto pairOf(Arm<Pattern, Func, hint> const &arm)
+        {
+            return arm.pair();
+        }
+
+        template <std::size_t idx, typename Arm>
+        class ArmSlot
+        {
+        public:
+            Arm const mArm;
+        };
+
+        // The arms of a matcher, each in a base of its own. Finding one by its
+        // index is a single overload resolution, where std::get on a tuple of
+        // hundreds of arms takes minutes to compile.
+        template <std::size_t... I, typename... Arms>
+        class ArmSlots<std::index_sequence<I...>, Arms...> : public ArmSlot<I, Arms>...
+        {
+        public:
+            template <typename... PatternPairs>
+            constexpr explicit ArmSlots(PatternPairs const &...patterns)
+                : ArmSlot<I, Arms>{Arms{patterns}}...
+            {
+            }
+            template <typename Func>
+            constexpr decltype(auto) apply(Func const &func) const
+            {
+                return func(static_cast<ArmSlot<I, Arms> const &>(*this).mArm...);
+            }
+        };
+
+        template <std::size_t idx, typename Arm>
+        constexpr auto const &armAt(ArmSlot<idx, Arm> const &slot)
+        {
+            return slot.mArm;
+        }
+
+        // Arms built once and applied to many values. The table of their
+        // literals, intervals or string literals is built once too.
+        template <typename... Arms>
+        class Matcher
+        {
+        public:
+            template <typename... PatternPairs>
+            constexpr explicit Matcher(PatternPairs const &...patterns)
+                : mArms{patterns...},
+                  mTable{siteTable(patterns...)} {}
+            template <typename Value>
+            constexpr auto operator()(Value &&value) const
+            {
+                return rematchPatterns(std::forward<Value>(value), mTable, mArms);
+            }
+            template <typename First, typename Second, typename... Values>
+            constexpr auto operator()(First &&first, Second &&second, Values &&...values) const
+            {
+                return operator()(std::forward_as_tuple(std::forward<First>(first),
+                                                        std::forward<Second>(second),
+                                                        std::forward<Values>(values)...));
+            }
+            // matchAll over a range with these arms.
+            template <typename Range, typename Out>
+            constexpr auto all(Range &&range, Out out) const
+            {
+                return mArms.apply([&range, out](auto const &...arms)
+                                   { return matchAll(std::forward<Range>(range), out, arms.pair()...); });
+            }
+
+        private:
+            ArmSlots<std::index_sequence_for<Arms...>, Arms...> const mArms;
+            decltype(siteTable(std::declval<Arms const &>().pair()...)) const mTable;
+        };
+
+        template <typename... Patterns, typename... Funcs, Hint... hints>
+        constexpr auto matcher(PatternPair<Patterns, Funcs, hints> const &...patterns)
+        {
+            return Matcher<Arm<Patterns, Funcs, hints>...>{patterns...};
+        }
+
+        // The bindings of one call of a matcher that owns its Ids. Its Ids are
+        // placeholders, slot i binds into mBlocks[i] of the innermost frame of
+        // that matcher on the thread.
+        class BindingFrame
+        {
+        public:
+            void const *const *mSlots;
+            void *const *mBlocks;
+            std::size_t mNbIds;
+            BindingFrame const *mOuter;
+        };
+
+        inline BindingFrame const *&bindingFrame()
+        {
+            thread_local BindingFrame const *frame = nullptr;
+            return frame;
+        }
+
+        template <typename Storage>
+        struct PerCall;
+        template <typename T, typename Storage>
+        class Id;
+
+        template <typename IdT>
+        class PerCallId;
+
+        template <typename T, typename Storage>
+        class PerCallId<Id<T, Storage>>
+        {
+        public:
+            using type = Id<T, PerCall<Storage>>;
+        };
+
+        // Calls the builder once with placeholder Ids, by reference, and applies
+        // the matcher it returns. Each call binds into blocks of its own, found
+        // through its frame, so calls can nest or run on several threads.
+        template <typename Builder, typename... Ids>
+        class BindingMatcher
+        {
+            using IdsT = std::tuple<typename PerCallId<Ids>::type...>;
+
+            template <std::size_t... I>
+            constexpr static auto slots(IdsT const &ids, std::index_sequence<I...>)
+            {
+                return std::array<void const *, sizeof...(Ids)>{&std::get<I>(ids).mInline...};
+            }
+
+            // The blocks of one call, the innermost frame of the thread while it
+            // runs.
+            class Call
+            {
+            public:
+                explicit Call(BindingMatcher const &owner)
+                    : mBlockPtrs{blockPtrs(std::index_sequence_for<Ids...>{})},
+                      mFrame{owner.mSlots.data(), mBlockPtrs.data(), sizeof...(Ids), bindingFrame()}
+                {
+                    bindingFrame() = &mFrame;
+                }
+                Call(Call const &) = delete;
+                Call &operator=(Call const &) = delete;
+                ~Call() { bindingFrame() = mFrame.mOuter; }
+
+            private:
+                template <std::size_t... I>
+                auto blockPtrs(std::index_sequence<I...>)
+                {
+                    return std::array<void *, sizeof...(Ids)>{&std::get<I>(mBlocks)...};
+                }
+
+                std::tuple<typename PerCallId<Ids>::type::Block...> mBlocks;
+                std::array<void *, sizeof...(Ids)> const mBlockPtrs;
+                BindingFrame const mFrame;
+            };
+
+        public:
+            explicit BindingMatcher(Builder const &builder)
+                : mIds{}, mMatcher{std::apply(builder, mIds)},
+                  mSlots{slots(mIds, std::index_sequence_for<Ids...>{})}
+            {
+                int32_t slot = 0;
+                std::apply([&slot](auto &...ids) { ((ids.mInline.mDepth = -++slot), ...); },
+                           mIds);
+            }
+            // the arms refer to mIds.
+            BindingMatcher(BindingMatcher const &) = delete;
+            BindingMatcher &operator=(BindingMatcher const &) = delete;
+            template <typename... Values>
+            auto operator()(Values &&...values) const
+            {
+                Call const call{*this};
+                return mMatcher(std::forward<Values>(values)...);
+            }
+            template <typename Range, typename Out>
+            auto all(Range &&range, Out out) const
+            {
+                Call const call{*this};
+                return mMatcher.all(std::forward<Range>(range), out);
+            }
+
+        private:
+            IdsT mIds;
+            decltype(std::apply(std::declval<Builder const &>(), std::declval<IdsT &>())) const
+                mMatcher;
+            std::array<void const *, sizeof...(Ids)> const mSlots;
+        };
+
+        template <typename... Ids, typename Builder,
+                  std::enable_if_t<
+                      std::is_invocable_v<Builder, typename PerCallId<Ids>::type &...>, bool> = true>
+        auto matcher(Builder const &builder)
+        {
+            return BindingMatcher<Builder, Ids...>{builder};
+        }
     } // namespace impl
 
     // export symbols
+    using impl::dumpMatchStats;
     using impl::match;
+    using impl::MatchSite;
+    using impl::matcher;
+    using impl::tryMatch;
 
 } // namespace matchit
 #endif // MATCHIT_CORE_H
@@ -1,7 +1,9 @@
 #ifndef MATCHIT_EXPRESSION_H
 #define MATCHIT_EXPRESSION_H
 
+#include <functional>
 #include <type_traits>
+#include <utility>
 
 namespace matchit
 {
@@ -20,20 +22,55 @@ namespace matchit
             return Nullary<T>{t};
         }
 
-        template <typename T>
+        // Storage policies for Id.
+        // ByRef only binds lvalues, by address, and never stores a copy of T.
+        // ByValue always stores a copy.
+        // Auto binds lvalues by address and copies everything else. Parts of a
+        // temporary subject are moved in once their arm wins.
+        // PerCall<Storage> is an Id a matcher owns, see matcher<Ids...>(builder).
+        // It binds like Storage, into the storage of the current call.
+        struct ByRef
+        {
+        };
+        struct ByValue
+        {
+        };
+        struct Auto
+        {
+        };
+        template <typename Storage = Auto>
+        struct PerCall
+        {
+        };
+
+        template <typename Storage>
+        class BaseStorage
+        {
+        public:
+            using type = Storage;
+        };
+
+        template <typename Storage>
+        class BaseStorage<PerCall<Storage>>
+        {
+        public:
+            using type = Storage;
+        };
+
+        template <typename T, typename Storage = Auto>
         class Id;
-        template <typename T>
-        constexpr auto expr(Id<T> &id)
+        template <typename T, typename Storage>
+        constexpr auto expr(Id<T, Storage> &id)
         {
             return nullary([&]
                            { return *id; });
         }
-
-        template <typename T>
-        constexpr auto expr(T const &v)
+        // expr(std::move(id)) hands the handler the bound value moved out of id.
+        template <typename T, typename Storage>
+        constexpr auto expr(Id<T, Storage> &&id)
         {
-            return nullary([&]
-                           { return v; });
+            return nullary([&id]
+                           { return T{id.move()}; });
         }
 
         // for constant
@@ -56,13 +93,13 @@ namespace matchit
         };
 
         // Only allowed in nullary
-        template <typename T>
-        class EvalTraits<Id<T>>
+        template <typename T, typename Storage>
+        class EvalTraits<Id<T, Storage>>
         {
         public:
-            constexpr static decltype(auto) evalImpl(Id<T> const &id)
+            constexpr static decltype(auto) evalImpl(Id<T, Storage> const &id)
             {
-                return *const_cast<Id<T> &>(id);
+                return *const_cast<Id<T, Storage> &>(id);
             }
         };
 
@@ -102,13 +139,57 @@ namespace matchit
             return EvalTraits<T>::evalImpl(t, args...);
         }
 
+        // Refers to an lvalue operand, or to one that can not be moved, arrays
+        // included.
         template <typename T>
-        class IsNullaryOrId : public std::false_type
+        class Ref
         {
+        public:
+            T const *mPtr;
         };
 
         template <typename T>
-        class IsNullaryOrId<Id<T>> : public std::true_type
+        class EvalTraits<Ref<T>>
+        {
+        public:
+            template <typename... Args>
+            constexpr static decltype(auto) evalImpl(Ref<T> const &ref, Args const &...args)
+            {
+                return evaluate_(*ref.mPtr, args...);
+            }
+        };
+
+        // Lvalue operands are referred to, as the expressions of a match never
+        // outlive them. Temporaries are moved in, so that the arms stored in a
+        // matcher do not refer to them once they are gone.
+        template <typename T>
+        constexpr auto capture(T &&t)
+        {
+            using ValueT = std::remove_cv_t<std::remove_reference_t<T>>;
+            if constexpr (std::is_lvalue_reference_v<T> || !std::is_move_constructible_v<ValueT>)
+            {
+                return Ref<std::remove_reference_t<T>>{&t};
+            }
+            else
+            {
+                return ValueT(std::move(t));
+            }
+        }
+
+        template <typename T>
+        constexpr auto expr(T &&v)
+        {
+            return nullary([v = capture(std::forward<T>(v))]
+                           { return evaluate_(v); });
+        }
+
+        template <typename T>
+        class IsNullaryOrId : public std::false_type
+        {
+        };
+
+        template <typename T, typename Storage>
+        class IsNullaryOrId<Id<T, Storage>> : public std::true_type
         {
         };
 
@@ -122,18 +203,23 @@ namespace matchit
 
 #define UN_OP_FOR_NULLARY(op)                                               \
     template <typename T, std::enable_if_t<isNullaryOrIdV<T>, bool> = true> \
-    constexpr auto operator op(T const &t)                                  \
+    constexpr auto operator op(T &&t)                                       \
     {                                                                       \
-        return nullary([&] { return op evaluate_(t); });                         \
+        return nullary([t = capture(std::forward<T>(t))] {                  \
+            return op evaluate_(t);                                         \
+        });                                                                 \
     }
 
 #define BIN_OP_FOR_NULLARY(op)                                                 \
     template <typename T, typename U,                                          \
               std::enable_if_t<isNullaryOrIdV<T> || isNullaryOrIdV<U>, bool> = \
                   true>                                                        \
-    constexpr auto operator op(T const &t, U const &u)                         \
+    constexpr auto operator op(T &&t, U &&u)                                   \
     {                                                                          \
-        return nullary([&] { return evaluate_(t) op evaluate_(u); });                    \
+        return nullary([t = capture(std::forward<T>(t)),                       \
+                        u = capture(std::forward<U>(u))] {                     \
+            return evaluate_(t) op evaluate_(u);                               \
+        });                                                                    \
     }
 
         // ADL will find these operators.
@@ -178,6 +264,52 @@ namespace matchit
         template <typename T>
         constexpr auto isUnaryOrWildcardV = IsUnaryOrWildcard<std::decay_t<T>>::value;
 
+        template <typename T, typename Cmp, bool wildcardFirst>
+        class Bound;
+
+        template <typename T>
+        constexpr auto isBoundOperandV = !isUnaryOrWildcardV<T> && !isNullaryOrIdV<T>;
+
+        // `_ < 10` and friends make a Bound, see BOUND_OP_FOR_WILDCARD.
+        template <typename T, typename U>
+        constexpr auto isBoundArgsV =
+            (std::is_same_v<std::decay_t<T>, Wildcard> && isBoundOperandV<U>) ||
+            (isBoundOperandV<T> && std::is_same_v<std::decay_t<U>, Wildcard>);
+
+        // The Bound of a `_ < 10` like operand, void for other operands.
+        template <typename T>
+        class BoundArg
+        {
+        public:
+            using type = void;
+        };
+
+        template <typename T, typename Cmp, bool wildcardFirst>
+        class BoundArg<Unary<Bound<T, Cmp, wildcardFirst>>>
+        {
+        public:
+            using type = Bound<T, Cmp, wildcardFirst>;
+        };
+
+        // A lower and an upper bound make an Interval.
+        template <typename T, typename U>
+        constexpr bool isIntervalArgs()
+        {
+            using First = typename BoundArg<std::decay_t<T>>::type;
+            using Second = typename BoundArg<std::decay_t<U>>::type;
+            if constexpr (!std::is_void_v<First> && !std::is_void_v<Second>)
+            {
+                return First::isLower != Second::isLower;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        template <typename T, typename U>
+        constexpr auto isIntervalArgsV = isIntervalArgs<T, U>();
+
         // unary is an alias of meet.
         template <typename T>
         constexpr auto unary(T &&t)
@@ -187,19 +319,24 @@ namespace matchit
 
 #define UN_OP_FOR_UNARY(op)                                                     \
     template <typename T, std::enable_if_t<isUnaryOrWildcardV<T>, bool> = true> \
-    constexpr auto operator op(T const &t)                                      \
+    constexpr auto operator op(T &&t)                                           \
     {                                                                           \
-        return unary([&](auto &&arg) constexpr { return op evaluate_(t, arg); });    \
+        return unary([t = capture(std::forward<T>(t))](auto &&arg) constexpr {  \
+            return op evaluate_(t, arg);                                        \
+        });                                                                     \
     }
 
-#define BIN_OP_FOR_UNARY(op)                                                   \
+// excluded: the operands that a more specific overload below takes.
+#define BIN_OP_FOR_UNARY(op, excluded)                                         \
     template <typename T, typename U,                                          \
-              std::enable_if_t<isUnaryOrWildcardV<T> || isUnaryOrWildcardV<U>, \
+              std::enable_if_t<(isUnaryOrWildcardV<T> || isUnaryOrWildcardV<U>)&& \
+                                   !(excluded),                                \
                                bool> = true>                                   \
-    constexpr auto operator op(T const &t, U const &u)                         \
+    constexpr auto operator op(T &&t, U &&u)                                   \
     {                                                                          \
-        return unary([&](auto &&arg) constexpr {                               \
-            return evaluate_(t, arg) op evaluate_(u, arg);                               \
+        return unary([t = capture(std::forward<T>(t)),                         \
+                      u = capture(std::forward<U>(u))](auto &&arg) constexpr { \
+            return evaluate_(t, arg) op evaluate_(u, arg);                     \
         });                                                                    \
     }
 
@@ -208,23 +345,155 @@ namespace matchit
 
 #undef UN_OP_FOR_UNARY
 
-        BIN_OP_FOR_UNARY(+)
-        BIN_OP_FOR_UNARY(-)
-        BIN_OP_FOR_UNARY(*)
-        BIN_OP_FOR_UNARY(/)
-        BIN_OP_FOR_UNARY(%)
-        BIN_OP_FOR_UNARY(<)
-        BIN_OP_FOR_UNARY(<=)
-        BIN_OP_FOR_UNARY(==)
-        BIN_OP_FOR_UNARY(!=)
-        BIN_OP_FOR_UNARY(>=)
-        BIN_OP_FOR_UNARY(>)
-        BIN_OP_FOR_UNARY(||)
-        BIN_OP_FOR_UNARY(&&)
-        BIN_OP_FOR_UNARY(^)
+        BIN_OP_FOR_UNARY(+, false)
+        BIN_OP_FOR_UNARY(-, false)
+        BIN_OP_FOR_UNARY(*, false)
+        BIN_OP_FOR_UNARY(/, false)
+        BIN_OP_FOR_UNARY(%, false)
+        BIN_OP_FOR_UNARY(<, (isBoundArgsV<T, U>))
+        BIN_OP_FOR_UNARY(<=, (isBoundArgsV<T, U>))
+        BIN_OP_FOR_UNARY(==, false)
+        BIN_OP_FOR_UNARY(!=, false)
+        BIN_OP_FOR_UNARY(>=, (isBoundArgsV<T, U>))
+        BIN_OP_FOR_UNARY(>, (isBoundArgsV<T, U>))
+        BIN_OP_FOR_UNARY(||, false)
+        BIN_OP_FOR_UNARY(&&, (isIntervalArgsV<T, U>))
+        BIN_OP_FOR_UNARY(^, false)
 
 #undef BIN_OP_FOR_UNARY
 
+        // The value type of an operand made by capture.
+        template <typename T>
+        class OperandValue
+        {
+        public:
+            using type = T;
+        };
+
+        template <typename T>
+        class OperandValue<Ref<T>>
+        {
+        public:
+            using type = std::remove_cv_t<T>;
+        };
+
+        // `lo <= _`, `_ < hi` and friends, kept as named types so that intervals can
+        // be recognized at compile time. Evaluated exactly as written. The operand is
+        // captured as for the other operators: Ref<T> to an lvalue, a T otherwise.
+        template <typename T, typename Cmp, bool wildcardFirst>
+        class Bound
+        {
+        public:
+            using ValueT = typename OperandValue<T>::type;
+            constexpr static auto isLower =
+                wildcardFirst == (std::is_same_v<Cmp, std::greater<>> ||
+                                  std::is_same_v<Cmp, std::greater_equal<>>);
+            constexpr static auto isInclusive =
+                std::is_same_v<Cmp, std::less_equal<>> ||
+                std::is_same_v<Cmp, std::greater_equal<>>;
+
+            constexpr explicit Bound(T const &operand)
+                : mOperand{operand}
+            {
+            }
+            template <typename Arg>
+            constexpr auto operator()(Arg const &arg) const
+            {
+                if constexpr (wildcardFirst)
+                {
+                    return Cmp{}(arg, value());
+                }
+                else
+                {
+                    return Cmp{}(value(), arg);
+                }
+            }
+            constexpr decltype(auto) value() const
+            {
+                return evaluate_(mOperand);
+            }
+
+        private:
+            T mOperand;
+        };
+
+        static_assert(Bound<int32_t, std::less_equal<>, false>::isLower);
+        static_assert(Bound<int32_t, std::greater<>, true>::isLower);
+        static_assert(!Bound<int32_t, std::less<>, true>::isLower);
+        static_assert(!Bound<int32_t, std::less<>, true>::isInclusive);
+
+        // `lo <= _ && _ <= hi`, and the half-open variants.
+        template <typename First, typename Second>
+        class Interval
+        {
+        public:
+            constexpr Interval(First const &first, Second const &second)
+                : mFirst{first}, mSecond{second}
+            {
+            }
+            template <typename Arg>
+            constexpr bool operator()(Arg const &arg) const
+            {
+                return mFirst(arg) && mSecond(arg);
+            }
+            constexpr auto const &lower() const
+            {
+                if constexpr (First::isLower)
+                {
+                    return mFirst;
+                }
+                else
+                {
+                    return mSecond;
+                }
+            }
+            constexpr auto const &upper() const
+            {
+                if constexpr (First::isLower)
+                {
+                    return mSecond;
+                }
+                else
+                {
+                    return mFirst;
+                }
+            }
+
+        private:
+            First mFirst;
+            Second mSecond;
+        };
+
+#define BOUND_OP_FOR_WILDCARD(op, Cmp)                                          \
+    template <typename T, std::enable_if_t<isBoundOperandV<T>, bool> = true>   \
+    constexpr auto operator op(Wildcard const &, T &&t)                        \
+    {                                                                          \
+        auto operand = capture(std::forward<T>(t));                            \
+        return unary(Bound<decltype(operand), Cmp, true>{operand});            \
+    }                                                                          \
+    template <typename T, std::enable_if_t<isBoundOperandV<T>, bool> = true>   \
+    constexpr auto operator op(T &&t, Wildcard const &)                        \
+    {                                                                          \
+        auto operand = capture(std::forward<T>(t));                            \
+        return unary(Bound<decltype(operand), Cmp, false>{operand});           \
+    }
+
+        BOUND_OP_FOR_WILDCARD(<, std::less<>)
+        BOUND_OP_FOR_WILDCARD(<=, std::less_equal<>)
+        BOUND_OP_FOR_WILDCARD(>=, std::greater_equal<>)
+        BOUND_OP_FOR_WILDCARD(>, std::greater<>)
+
+#undef BOUND_OP_FOR_WILDCARD
+
+        template <typename T1, typename Cmp1, bool w1, typename T2, typename Cmp2, bool w2,
+                  std::enable_if_t<Bound<T1, Cmp1, w1>::isLower != Bound<T2, Cmp2, w2>::isLower,
+                                   bool> = true>
+        constexpr auto operator&&(Unary<Bound<T1, Cmp1, w1>> const &first,
+                                  Unary<Bound<T2, Cmp2, w2>> const &second)
+        {
+            return unary(Interval<Bound<T1, Cmp1, w1>, Bound<T2, Cmp2, w2>>{first, second});
+        }
+
     } // namespace impl
     using impl::expr;
 } // namespace matchit
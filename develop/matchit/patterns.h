@@ -2,42 +2,98 @@
 #define MATCHIT_PATTERNS_H
 
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
 #include <stdexcept>
+#include <string_view>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 #include <variant>
+#ifdef MATCHIT_PARALLEL
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
 
 namespace matchit
 {
     namespace impl
     {
+        template <typename I>
+        constexpr bool isRandomAccessV = std::is_base_of_v<
+            std::random_access_iterator_tag, typename std::iterator_traits<I>::iterator_category>;
+
+        // Subranges of lists or sets remember their length, so that size() does not
+        // walk them. Random access ones compute it and stay two iterators wide.
+        template <bool cached>
+        class SubrangeLength
+        {
+        public:
+            constexpr explicit SubrangeLength(size_t const size) : mSize{size} {}
+            constexpr size_t cachedSize() const { return mSize; }
+
+        private:
+            size_t mSize;
+        };
+
+        template <>
+        class SubrangeLength<false>
+        {
+        public:
+            constexpr explicit SubrangeLength(size_t const) {}
+        };
+
         template <typename I, typename S = I>
-        class Subrange
+        class Subrange : private SubrangeLength<!isRandomAccessV<I>>
         {
+            using LengthT = SubrangeLength<!isRandomAccessV<I>>;
             I mBegin;
             S mEnd;
 
         public:
-            constexpr Subrange(I const begin, S const end) : mBegin{begin}, mEnd{end} {}
+            constexpr Subrange(I const begin, S const end)
+                : LengthT{isRandomAccessV<I> ? 0 : static_cast<size_t>(std::distance(begin, end))},
+                  mBegin{begin}, mEnd{end} {}
+            constexpr Subrange(I const begin, S const end, size_t const size)
+                : LengthT{size}, mBegin{begin}, mEnd{end} {}
 
             constexpr Subrange(Subrange const &other)
-                : mBegin{other.begin()}, mEnd{other.end()} {}
+                : LengthT{other}, mBegin{other.begin()}, mEnd{other.end()} {}
 
             Subrange &operator=(Subrange const &other)
             {
+                LengthT::operator=(other);
                 mBegin = other.begin();
                 mEnd = other.end();
                 return *this;
             }
 
-            size_t size() const
+            constexpr size_t size() const
             {
-                return static_cast<size_t>(std::distance(mBegin, mEnd));
+                if constexpr (isRandomAccessV<I>)
+                {
+                    return static_cast<size_t>(std::distance(mBegin, mEnd));
+                }
+                else
+                {
+                    return LengthT::cachedSize();
+                }
             }
-            auto begin() const { return mBegin; }
-            auto end() const { return mEnd; }
+            constexpr auto begin() const { return mBegin; }
+            constexpr auto end() const { return mEnd; }
         };
 
         template <typename I, typename S>
@@ -46,6 +102,12 @@ namespace matchit
             return Subrange<I, S>{begin, end};
         }
 
+        template <typename I, typename S>
+        constexpr auto makeSubrange(I begin, S end, size_t size)
+        {
+            return Subrange<I, S>{begin, end, size};
+        }
+
         template <typename RangeType>
         class IterUnderlyingType
         {
@@ -227,7 +289,12 @@ namespace matchit
         enum class IdProcess : int32_t
         {
             kCANCEL,
-            kCONFIRM
+            kCONFIRM,
+            // the handler of an arm that matched a temporary subject returned, its Ids
+            // take over what they bound inside it.
+            kOWN,
+            // the match is over, memos drop the subject they cached.
+            kFORGET
         };
 
         template <typename Pattern>
@@ -247,6 +314,121 @@ namespace matchit
             using type = std::variant<std::monostate, T, Ts...>;
         };
 
+        template <typename T>
+        class IsStdTuple : public std::false_type
+        {
+        };
+
+        template <typename... Ts>
+        class IsStdTuple<std::tuple<Ts...>> : public std::true_type
+        {
+        };
+
+        template <typename T>
+        bool containsAddress(void const *object, void const *ptr);
+
+        template <typename Element, typename T>
+        bool elementContainsAddress(T const &element, void const *ptr)
+        {
+            if constexpr (std::is_rvalue_reference_v<Element>)
+            {
+                return containsAddress<T>(std::addressof(element), ptr);
+            }
+            else
+            {
+                static_cast<void>(element);
+                static_cast<void>(ptr);
+                return false;
+            }
+        }
+
+        template <typename Tuple, std::size_t... I>
+        bool elementsContainAddress(Tuple const &elements, void const *ptr,
+                                    std::index_sequence<I...>)
+        {
+            return (elementContainsAddress<std::tuple_element_t<I, Tuple>>(std::get<I>(elements),
+                                                                           ptr) ||
+                    ...);
+        }
+
+        // ptr points into object, or into what an rvalue reference element of a
+        // tuple refers to, as for the values of match(a, std::move(b)).
+        template <typename T>
+        bool containsAddress(void const *object, void const *ptr)
+        {
+            auto const begin = reinterpret_cast<std::uintptr_t>(object);
+            auto const address = reinterpret_cast<std::uintptr_t>(ptr);
+            if (begin <= address && address < begin + sizeof(T))
+            {
+                return true;
+            }
+            if constexpr (IsStdTuple<T>::value)
+            {
+                if constexpr (std::tuple_size_v<T> != 0)
+                {
+                    return elementsContainAddress(*static_cast<T const *>(object), ptr,
+                                                  std::make_index_sequence<std::tuple_size_v<T>>{});
+                }
+            }
+            return false;
+        }
+
+        // A part of a temporary subject an Id bound by address, and whether that
+        // Id may move from it.
+        class BoundPart
+        {
+        public:
+            std::uintptr_t mBegin = 0;
+            std::uintptr_t mEnd = 0;
+            bool *mMovable = nullptr;
+        };
+
+        // The temporary subject of a match. The Ids of the winning arm move what
+        // they bound inside it into their own storage once the handler returned,
+        // so that they outlive it.
+        // The caller's lvalues and the objects a projection merely refers to stay
+        // bound by address and are never moved from.
+        class OwnedSubject
+        {
+        public:
+            void const *mObject = nullptr;
+            bool (*mContains)(void const *object, void const *ptr) = nullptr;
+            // addresses can not be compared in constant evaluation, every binding
+            // by address is copied then.
+            bool mUnknown = false;
+            // the parts bound so far by the arm, see OwningContext.
+            BoundPart *mParts = nullptr;
+            std::size_t mCapacity = 0;
+            mutable std::size_t mNbParts = 0;
+
+            constexpr bool contains(void const *ptr) const
+            {
+                return mContains != nullptr && mContains(mObject, ptr);
+            }
+            // Records a part an Id bound by address. The Ids bound before to parts
+            // overlapping it copy theirs instead of moving, so that data bound
+            // several times, as by x.at(ds(y, _)), is moved last.
+            void addPart(void const *part, std::size_t size, bool *movable) const
+            {
+                auto const begin = reinterpret_cast<std::uintptr_t>(part);
+                auto const end = begin + size;
+                for (std::size_t i = 0; i < mNbParts; ++i)
+                {
+                    if (mParts[i].mBegin < end && begin < mParts[i].mEnd)
+                    {
+                        *mParts[i].mMovable = false;
+                    }
+                }
+                if (mNbParts == mCapacity)
+                {
+                    // later parts could not see this one.
+                    *movable = false;
+                    return;
+                }
+                mParts[mNbParts++] = BoundPart{begin, end, movable};
+            }
+        };
+
         template <typename... Ts>
         class Context
         {
@@ -270,6 +452,55 @@ namespace matchit
         {
         };
 
+        // The context of an arm matched against a temporary subject of type
+        // Subject, with room for the parts its nbIds Ids bind. Plain contexts stay
+        // empty for the arms that need no intermediates.
+        template <typename ContextT, typename Subject, std::size_t nbIds>
+        class OwningContext : public ContextT
+        {
+        public:
+            constexpr explicit OwningContext(OwnedSubject const &subject) : mSubject{subject}
+            {
+                mSubject.mParts = mParts.data();
+                mSubject.mCapacity = nbIds;
+            }
+            OwningContext(OwningContext const &) = delete;
+            OwningContext &operator=(OwningContext const &) = delete;
+            constexpr OwnedSubject const &subject() const { return mSubject; }
+
+        private:
+            OwnedSubject mSubject;
+            std::array<BoundPart, nbIds> mParts{};
+        };
+
+        template <typename ContextT>
+        constexpr OwnedSubject ownedSubject(ContextT const &)
+        {
+            return {};
+        }
+
+        template <typename ContextT, typename Subject, std::size_t nbIds>
+        constexpr OwnedSubject const &
+        ownedSubject(OwningContext<ContextT, Subject, nbIds> const &context)
+        {
+            return context.subject();
+        }
+
+        // The values of match(a, b) only refer to a and b.
+        template <typename Subject>
+        constexpr bool refersOnlyV = false;
+
+        template <typename... Ts>
+        constexpr bool refersOnlyV<std::tuple<Ts...>> = (std::is_lvalue_reference_v<Ts> && ...);
+
+        // Whether the arm may bind into a subject that dies with the match.
+        template <typename ContextT>
+        constexpr bool bindsIntoTemporaryV = false;
+
+        template <typename ContextT, typename Subject, std::size_t nbIds>
+        constexpr bool bindsIntoTemporaryV<OwningContext<ContextT, Subject, nbIds>> =
+            !refersOnlyV<Subject>;
+
         template <typename T>
         class ContextTrait;
 
@@ -280,6 +511,12 @@ namespace matchit
             using ContextT = Context<Ts...>;
         };
 
+        // Each arm gets a context sized for the intermediates of its own pattern,
+        // not of every arm of the match.
+        template <typename Value, typename PatternPair>
+        using ArmContextT = typename ContextTrait<typename PatternTraits<
+            typename PatternPair::PatternT>::template AppResultTuple<Value>>::ContextT;
+
         template <typename Value, typename Pattern, typename ConctextT>
         constexpr auto matchPattern(Value &&value, Pattern const &pattern,
                                     int32_t depth, ConctextT &context)
@@ -291,28 +528,83 @@ namespace matchit
             return result;
         }
 
-        template <typename Pattern, typename Func>
+        // Cold handlers are called out of line, away from the hot path.
+        template <typename Func>
+        MATCHIT_COLD constexpr auto executeCold(Func const &func)
+        {
+            return func();
+        }
+
+        template <typename Pattern, typename Func, Hint hint>
         class PatternPair
         {
         public:
             using RetType = std::invoke_result_t<Func>;
             using PatternT = Pattern;
+            constexpr static auto kHINT = hint;
 
             constexpr PatternPair(Pattern const &pattern, Func const &func)
                 : mPattern{pattern}, mHandler{func} {}
+#ifdef MATCHIT_STATS
+            constexpr PatternPair(Pattern const &pattern, Func const &func, ArmStats *stats)
+                : mPattern{pattern}, mHandler{func}, mStats{stats} {}
+#endif
             template <typename Value, typename ContextT>
             constexpr bool matchValue(Value &&value, ContextT &context) const
             {
-                return matchPattern(std::forward<Value>(value), mPattern, /*depth*/ 0,
-                                    context);
+                auto const matched = matchPattern(std::forward<Value>(value), mPattern,
+                                                  /*depth*/ 0, context);
+                count(matched);
+                return matched;
+            }
+            // An attempt of this arm, dispatchers that decide it without matchValue
+            // count it too. Does nothing without MATCHIT_STATS.
+            constexpr void count(bool const matched) const
+            {
+#ifdef MATCHIT_STATS
+                if (mStats != nullptr)
+                {
+                    mStats->mAttempts.fetch_add(1, std::memory_order_relaxed);
+                    mStats->mFailures.fetch_add(matched ? 0 : 1, std::memory_order_relaxed);
+                }
+#else
+                static_cast<void>(matched);
+#endif
+            }
+            constexpr auto execute() const
+            {
+#ifdef MATCHIT_STATS
+                if (mStats != nullptr)
+                {
+                    mStats->mHits.fetch_add(1, std::memory_order_relaxed);
+                }
+#endif
+                if constexpr (hint == Hint::kCOLD)
+                {
+                    return executeCold(mHandler);
+                }
+                else
+                {
+                    return mHandler();
+                }
             }
-            constexpr auto execute() const { return mHandler(); }
+            constexpr auto const &pattern() const { return mPattern; }
+            constexpr auto const &handler() const { return mHandler; }
 
         private:
             Pattern const &mPattern;
             Func const &mHandler;
+#ifdef MATCHIT_STATS
+            ArmStats *mStats = nullptr;
+#endif
         };
 
+        template <typename Pattern, typename Func, Hint hint>
+        constexpr auto const &pairOf(PatternPair<Pattern, Func, hint> const &pair)
+        {
+            return pair;
+        }
+
         template <typename Pattern, typename Pred>
         class PostCheck;
 
@@ -329,7 +621,7 @@ namespace matchit
             return When<Pred>{pred};
         }
 
-        template <typename Pattern>
+        template <typename Pattern, Hint hint = Hint::kNONE>
         class PatternHelper
         {
         public:
@@ -338,12 +630,12 @@ namespace matchit
             template <typename Func>
             constexpr auto operator=(Func const &func)
             {
-                return PatternPair<Pattern, Func>{mPattern, func};
+                return PatternPair<Pattern, Func, hint>{mPattern, func};
             }
             template <typename Pred>
             constexpr auto operator|(When<Pred> const &w)
             {
-                return PatternHelper<PostCheck<Pattern, Pred>>(
+                return PatternHelper<PostCheck<Pattern, Pred>, hint>(
                     PostCheck(mPattern, w.mPred));
             }
 
@@ -357,31 +649,94 @@ namespace matchit
         template <typename... Patterns>
         constexpr auto ds(Patterns const &...patterns) -> Ds<Patterns...>;
 
-        template <typename Pattern>
+        template <typename Pattern, typename Storage = Auto>
         class OooBinder;
 
-        class PatternPipable
+        // Characters of a char array before its first null character.
+        constexpr std::size_t boundedLength(char const *str, std::size_t const n)
+        {
+            auto const end = std::char_traits<char>::find(str, n, '\0');
+            return end == nullptr ? n : static_cast<std::size_t>(end - str);
+        }
+
+        // A string literal pattern, or a const char array compared up to its first
+        // null character.
+        template <std::size_t N>
+        class StringLiteral
+        {
+        public:
+            constexpr explicit StringLiteral(char const (&str)[N])
+                : mData{str}, mSize{boundedLength(str, N)} {}
+            constexpr std::size_t size() const { return mSize; }
+            constexpr auto data() const { return mData; }
+
+        private:
+            char const *mData;
+            std::size_t mSize;
+        };
+
+        // A mutable char array in a string pattern, its length is read when
+        // matching.
+        template <std::size_t N>
+        class CharBuffer
+        {
+        public:
+            constexpr explicit CharBuffer(char const (&str)[N]) : mData{str} {}
+            constexpr std::size_t size() const { return boundedLength(mData, N); }
+            constexpr auto data() const { return mData; }
+
+        private:
+            char const *mData;
+        };
+
+        template <Hint hint>
+        class HintedPipable
         {
         public:
             template <typename Pattern>
             constexpr auto operator|(Pattern const &p) const
             {
-                return PatternHelper<Pattern>{p};
+                if constexpr (std::is_same_v<std::remove_extent_t<Pattern>, char> &&
+                              std::extent_v<Pattern> != 0)
+                {
+                    return PatternHelper<StringLiteral<std::extent_v<Pattern>>, hint>{
+                        StringLiteral<std::extent_v<Pattern>>{p}};
+                }
+                else if constexpr (std::is_array_v<Pattern> || std::is_pointer_v<Pattern>)
+                {
+                    using T = std::remove_pointer_t<std::decay_t<Pattern>>;
+                    return PatternHelper<T const *, hint>{p};
+                }
+                else
+                {
+                    return PatternHelper<Pattern, hint>{p};
+                }
             }
 
-            template <typename T>
-            constexpr auto operator|(T const *p) const
+            // a mutable buffer may change after the pattern is made, it is compared
+            // as a pointer, as other arrays are.
+            template <std::size_t N>
+            constexpr auto operator|(char (&p)[N]) const
             {
-                return PatternHelper<T const *>{p};
+                return PatternHelper<char const *, hint>{p};
             }
 
-            template <typename Pattern>
-            constexpr auto operator|(OooBinder<Pattern> const &p) const
+            template <typename Pattern, typename Storage>
+            constexpr auto operator|(OooBinder<Pattern, Storage> const &p) const
             {
                 return operator|(ds(p));
             }
         };
 
+        // pattern.likely | ... marks the arm expected to match, pattern.cold | ...
+        // one that rarely does, its handler is kept out of line.
+        class PatternPipable : public HintedPipable<Hint::kNONE>
+        {
+        public:
+            HintedPipable<Hint::kLIKELY> likely{};
+            HintedPipable<Hint::kCOLD> cold{};
+        };
+
         constexpr PatternPipable pattern{};
 
         template <typename Pattern>
@@ -431,129 +786,485 @@ namespace matchit
                                                 IdProcess) {}
         };
 
-        template <typename... Patterns>
-        class Or
-        {
-        public:
-            constexpr explicit Or(Patterns const &...patterns) : mPatterns{patterns...} {}
-            constexpr auto const &patterns() const { return mPatterns; }
-
-        private:
-            std::tuple<Patterns...> mPatterns;
-        };
+        template <typename Value>
+        constexpr auto isStringLikeV =
+            std::is_class_v<std::decay_t<Value>> &&
+            std::is_convertible_v<Value const &, std::string_view>;
 
-        template <typename... Patterns>
-        constexpr auto or_(Patterns const &...patterns)
+        template <typename Literal>
+        constexpr bool literalEqual(Literal const &literal, std::string_view const str)
         {
-            return Or<Patterns...>{patterns...};
+            auto const size = literal.size();
+            return str.size() == size &&
+                   std::char_traits<char>::compare(str.data(), literal.data(), size) == 0;
         }
 
-        template <typename... Patterns>
-        class PatternTraits<Or<Patterns...>>
+        // String literals and char buffers, compared with strings by their
+        // characters.
+        template <typename Literal>
+        class StringTraits
         {
+            using Pattern = Literal;
+
         public:
             template <typename Value>
-            using AppResultTuple = decltype(std::tuple_cat(
-                typename PatternTraits<Patterns>::template AppResultTuple<Value>{}...));
+            using AppResultTuple = std::tuple<>;
 
-            constexpr static auto nbIdV = (PatternTraits<Patterns>::nbIdV + ... + 0);
+            constexpr static auto nbIdV = 0;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
-                                                   Or<Patterns...> const &orPat,
-                                                   int32_t depth, ContextT &context)
-            {
-                constexpr auto patSize = sizeof...(Patterns);
-                return std::apply(
-                           [&value, depth, &context](auto const &...patterns)
-                           {
-                               return (matchPattern(value, patterns, depth + 1, context) ||
-                                       ...);
-                           },
-                           take<patSize - 1>(orPat.patterns())) ||
-                       matchPattern(std::forward<Value>(value),
-                                    get<patSize - 1>(orPat.patterns()), depth + 1, context);
-            }
-            constexpr static void processIdImpl(Or<Patterns...> const &orPat,
-                                                int32_t depth, IdProcess idProcess)
+            constexpr static bool matchPatternImpl(Value &&value, Pattern const &pattern,
+                                                   int32_t /* depth */,
+                                                   ContextT & /*context*/)
             {
-                return std::apply(
-                    [depth, idProcess](Patterns const &...patterns)
-                    {
-                        return (processId(patterns, depth, idProcess), ...);
-                    },
-                    orPat.patterns());
+                if constexpr (isStringLikeV<Value>)
+                {
+                    return literalEqual(pattern, value);
+                }
+                else
+                {
+                    // pointers are compared as before.
+                    return pattern.data() == std::forward<Value>(value);
+                }
             }
+            constexpr static void processIdImpl(Pattern const &, int32_t /*depth*/,
+                                                IdProcess) {}
         };
 
-        template <typename Pred>
-        class Meet : public Pred
+        template <std::size_t N>
+        class PatternTraits<StringLiteral<N>> : public StringTraits<StringLiteral<N>>
         {
-        public:
-            using Pred::operator();
         };
 
-        template <typename Pred>
-        constexpr auto meet(Pred const &pred)
+        template <std::size_t N>
+        class PatternTraits<CharBuffer<N>> : public StringTraits<CharBuffer<N>>
         {
-            return Meet<Pred>{pred};
+        };
+
+        // String literal sub-patterns keep their length in the type.
+        template <typename Pattern>
+        constexpr auto stringPattern(Pattern const &pattern)
+        {
+            if constexpr (std::is_same_v<std::remove_extent_t<Pattern>, char> &&
+                          std::extent_v<Pattern> != 0)
+            {
+                return StringLiteral<std::extent_v<Pattern>>{pattern};
+            }
+            else
+            {
+                return pattern;
+            }
         }
 
-        template <typename Pred>
-        class PatternTraits<Meet<Pred>>
+        template <std::size_t N>
+        constexpr auto stringPattern(char (&pattern)[N])
         {
-        public:
-            template <typename Value>
-            using AppResultTuple = std::tuple<>;
+            return CharBuffer<N>{pattern};
+        }
 
-            constexpr static auto nbIdV = 0;
+        // Pattern is deduced from a forwarding reference, so that mutable buffers
+        // are told apart from literals.
+        template <typename Pattern>
+        using StringPatternT = decltype(stringPattern(std::declval<Pattern &>()));
 
-            template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
-                                                   Meet<Pred> const &meetPat,
-                                                   int32_t /* depth */, ContextT &)
-            {
-                return meetPat(std::forward<Value>(value));
-            }
-            constexpr static void processIdImpl(Meet<Pred> const &, int32_t /*depth*/,
-                                                IdProcess) {}
+        enum class Affix
+        {
+            kPREFIX,
+            kSUFFIX
         };
 
-        template <typename Unary, typename Pattern>
-        class App
+        // A string starting or ending with a literal, the pattern is matched against
+        // the rest of it, a std::string_view over the same characters.
+        template <Affix affix, typename Literal, typename Pattern>
+        class AffixOf
         {
         public:
-            constexpr App(Unary &&unary, Pattern const &pattern)
-                : mUnary{std::forward<Unary>(unary)}, mPattern{pattern} {}
-            constexpr auto const &unary() const { return mUnary; }
-            constexpr auto const &pattern() const { return mPattern; }
+            constexpr AffixOf(Literal const &literal, Pattern const &rest)
+                : mLiteral{literal}, mRest{rest} {}
+            constexpr auto const &literal() const { return mLiteral; }
+            constexpr auto const &rest() const { return mRest; }
 
         private:
-            Unary const mUnary;
-            Pattern const mPattern;
+            Literal const mLiteral;
+            Pattern const mRest;
         };
 
-        template <typename Unary, typename Pattern>
-        constexpr auto app(Unary &&unary, Pattern const &pattern)
+        template <typename T>
+        constexpr auto isCharArrayV =
+            std::is_array_v<std::remove_reference_t<T>> &&
+            std::is_same_v<std::remove_cv_t<std::remove_extent_t<std::remove_reference_t<T>>>,
+                           char>;
+
+        template <typename Prefix, typename Pattern = Wildcard>
+        constexpr auto startsWith(Prefix &&prefix, Pattern &&rest = Wildcard{})
         {
-            return App<Unary, Pattern>{std::forward<Unary>(unary), pattern};
+            static_assert(isCharArrayV<Prefix>,
+                          "The prefix of startsWith is a string literal or a char array.");
+            return AffixOf<Affix::kPREFIX, StringPatternT<Prefix>, StringPatternT<Pattern>>{
+                stringPattern(prefix), stringPattern(rest)};
         }
 
-        constexpr auto y = 1;
-        static_assert(std::holds_alternative<int32_t const *>(
-            std::variant<std::monostate, const int32_t *>{&y}));
-
-        template <typename Unary, typename Pattern>
-        class PatternTraits<App<Unary, Pattern>>
+        template <typename Suffix, typename Pattern = Wildcard>
+        constexpr auto endsWith(Suffix &&suffix, Pattern &&rest = Wildcard{})
+        {
+            static_assert(isCharArrayV<Suffix>,
+                          "The suffix of endsWith is a string literal or a char array.");
+            return AffixOf<Affix::kSUFFIX, StringPatternT<Suffix>, StringPatternT<Pattern>>{
+                stringPattern(suffix), stringPattern(rest)};
+        }
+
+        template <Affix affix, typename Literal, typename Pattern>
+        class PatternTraits<AffixOf<affix, Literal, Pattern>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple =
+                typename PatternTraits<Pattern>::template AppResultTuple<std::string_view>;
+
+            constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
+
+            template <typename Value, typename ContextT>
+            constexpr static bool matchPatternImpl(Value &&value,
+                                                   AffixOf<affix, Literal, Pattern> const &affixPat,
+                                                   int32_t depth, ContextT &context)
+            {
+                static_assert(std::is_convertible_v<Value const &, std::string_view>,
+                              "startsWith and endsWith match strings.");
+                auto const str = std::string_view{value};
+                auto const size = affixPat.literal().size();
+                if (str.size() < size)
+                {
+                    return false;
+                }
+                auto const offset = affix == Affix::kPREFIX ? 0 : str.size() - size;
+                if (std::char_traits<char>::compare(str.data() + offset,
+                                                    affixPat.literal().data(), size) != 0)
+                {
+                    return false;
+                }
+                // a temporary, so that Ids own the view.
+                return matchPattern(affix == Affix::kPREFIX ? str.substr(size)
+                                                            : str.substr(0, offset),
+                                    affixPat.rest(), depth + 1, context);
+            }
+            constexpr static void processIdImpl(AffixOf<affix, Literal, Pattern> const &affixPat,
+                                                int32_t depth, IdProcess idProcess)
+            {
+                processId(affixPat.rest(), depth, idProcess);
+            }
+        };
+
+        template <typename Separator, typename Lhs, typename Rhs>
+        class SplitAt
+        {
+        public:
+            constexpr SplitAt(Separator const &separator, Lhs const &lhs, Rhs const &rhs)
+                : mSeparator{separator}, mLhs{lhs}, mRhs{rhs} {}
+            constexpr auto separator() const
+            {
+                if constexpr (std::is_same_v<Separator, char>)
+                {
+                    return mSeparator;
+                }
+                else
+                {
+                    return std::string_view{mSeparator.data(), mSeparator.size()};
+                }
+            }
+            constexpr auto const &lhs() const { return mLhs; }
+            constexpr auto const &rhs() const { return mRhs; }
+
+        private:
+            Separator const mSeparator;
+            Lhs const mLhs;
+            Rhs const mRhs;
+        };
+
+        // Splits a string at the first separator, a char or a string literal, and
+        // matches the views before and after it.
+        template <typename Separator, typename Lhs, typename Rhs>
+        constexpr auto splitAt(Separator &&separator, Lhs &&lhs, Rhs &&rhs)
+        {
+            using SeparatorT = StringPatternT<Separator>;
+            static_assert(std::is_same_v<SeparatorT, char> || isCharArrayV<Separator>,
+                          "The separator of splitAt is a char or a string literal.");
+            return SplitAt<SeparatorT, StringPatternT<Lhs>, StringPatternT<Rhs>>{
+                stringPattern(separator), stringPattern(lhs), stringPattern(rhs)};
+        }
+
+        template <typename Separator, typename Lhs, typename Rhs>
+        class PatternTraits<SplitAt<Separator, Lhs, Rhs>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple = decltype(std::tuple_cat(
+                std::declval<
+                    typename PatternTraits<Lhs>::template AppResultTuple<std::string_view>>(),
+                std::declval<
+                    typename PatternTraits<Rhs>::template AppResultTuple<std::string_view>>()));
+
+            constexpr static auto nbIdV = PatternTraits<Lhs>::nbIdV + PatternTraits<Rhs>::nbIdV;
+
+            template <typename Value, typename ContextT>
+            constexpr static bool matchPatternImpl(Value &&value,
+                                                   SplitAt<Separator, Lhs, Rhs> const &splitPat,
+                                                   int32_t depth, ContextT &context)
+            {
+                static_assert(std::is_convertible_v<Value const &, std::string_view>,
+                              "splitAt matches strings.");
+                auto const str = std::string_view{value};
+                auto const separator = splitPat.separator();
+                auto const pos = str.find(separator);
+                if (pos == std::string_view::npos)
+                {
+                    return false;
+                }
+                return matchPattern(str.substr(0, pos), splitPat.lhs(), depth + 1, context) &&
+                       matchPattern(str.substr(pos + separatorSize(separator)), splitPat.rhs(),
+                                    depth + 1, context);
+            }
+            constexpr static void processIdImpl(SplitAt<Separator, Lhs, Rhs> const &splitPat,
+                                                int32_t depth, IdProcess idProcess)
+            {
+                processId(splitPat.lhs(), depth, idProcess);
+                processId(splitPat.rhs(), depth, idProcess);
+            }
+
+        private:
+            template <typename T>
+            constexpr static std::size_t separatorSize(T const &separator)
+            {
+                if constexpr (std::is_same_v<T, char>)
+                {
+                    return 1;
+                }
+                else
+                {
+                    return separator.size();
+                }
+            }
+        };
+
+        template <typename... Patterns>
+        class Or
+        {
+        public:
+            constexpr explicit Or(Patterns const &...patterns) : mPatterns{patterns...} {}
+            constexpr auto const &patterns() const { return mPatterns; }
+
+        private:
+            std::tuple<Patterns...> mPatterns;
+        };
+
+        template <typename... Patterns>
+        constexpr auto or_(Patterns const &...patterns)
+        {
+            return Or<Patterns...>{patterns...};
+        }
+
+        template <typename... Patterns>
+        class PatternTraits<Or<Patterns...>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple = decltype(std::tuple_cat(
+                typename PatternTraits<Patterns>::template AppResultTuple<Value>{}...));
+
+            constexpr static auto nbIdV = (PatternTraits<Patterns>::nbIdV + ... + 0);
+
+            template <typename Value, typename ContextT>
+            constexpr static auto matchPatternImpl(Value &&value,
+                                                   Or<Patterns...> const &orPat,
+                                                   int32_t depth, ContextT &context)
+            {
+                constexpr auto patSize = sizeof...(Patterns);
+                return std::apply(
+                           [&value, depth, &context](auto const &...patterns)
+                           {
+                               return (matchPattern(value, patterns, depth + 1, context) ||
+                                       ...);
+                           },
+                           take<patSize - 1>(orPat.patterns())) ||
+                       matchPattern(std::forward<Value>(value),
+                                    get<patSize - 1>(orPat.patterns()), depth + 1, context);
+            }
+            constexpr static void processIdImpl(Or<Patterns...> const &orPat,
+                                                int32_t depth, IdProcess idProcess)
+            {
+                return std::apply(
+                    [depth, idProcess](Patterns const &...patterns)
+                    {
+                        return (processId(patterns, depth, idProcess), ...);
+                    },
+                    orPat.patterns());
+            }
+        };
+
+        template <typename Pred>
+        class Meet : public Pred
+        {
+        public:
+            using Pred::operator();
+        };
+
+        template <typename Pred>
+        constexpr auto meet(Pred const &pred)
+        {
+            return Meet<Pred>{pred};
+        }
+
+        template <typename Pred>
+        class PatternTraits<Meet<Pred>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple = std::tuple<>;
+
+            constexpr static auto nbIdV = 0;
+
+            template <typename Value, typename ContextT>
+            constexpr static auto matchPatternImpl(Value &&value,
+                                                   Meet<Pred> const &meetPat,
+                                                   int32_t /* depth */, ContextT &)
+            {
+                return meetPat(std::forward<Value>(value));
+            }
+            constexpr static void processIdImpl(Meet<Pred> const &, int32_t /*depth*/,
+                                                IdProcess) {}
+        };
+
+        template <typename Unary, typename Pattern>
+        class App
+        {
+        public:
+            constexpr App(Unary &&unary, Pattern const &pattern)
+                : mUnary{std::forward<Unary>(unary)}, mPattern{pattern} {}
+            constexpr auto const &unary() const { return mUnary; }
+            constexpr auto const &pattern() const { return mPattern; }
+
+        private:
+            Unary const mUnary;
+            Pattern const mPattern;
+        };
+
+        template <typename Unary, typename Pattern>
+        constexpr auto app(Unary &&unary, Pattern const &pattern)
+        {
+            return App<Unary, Pattern>{std::forward<Unary>(unary), pattern};
+        }
+
+        constexpr auto y = 1;
+        static_assert(std::holds_alternative<int32_t const *>(
+            std::variant<std::monostate, const int32_t *>{&y}));
+
+        // Member function projections are called out of line. Inlined into a match,
+        // GCC 12 keeps the virtual call path of a member pointer whose value it no
+        // longer knows, and warns that it reads a vtable pointer past small
+        // subjects. A memo projects each subject once, the call costs little.
+        template <typename Unary, typename Subject>
+        MATCHIT_NOINLINE decltype(auto) invokeMember(Unary const unary, Subject const &subject)
+        {
+            return (subject.*unary)();
+        }
+
+        template <typename Unary, typename Subject>
+        decltype(auto) project(Unary const &unary, Subject const &subject)
+        {
+            if constexpr (std::is_member_function_pointer_v<Unary>)
+            {
+                return invokeMember(unary, subject);
+            }
+            else
+            {
+                return invoke_(unary, subject);
+            }
+        }
+
+        // A pure projection computed once per subject within a match, then reused
+        // by the later arms that apply it. Declare it before the match, like an Id,
+        // and apply it to the subject or to parts of it that outlive the match.
+        // The cache is keyed by the address of the subject and lives in the memo,
+        // so a memo is used by one thread at a time. A later subject of the same
+        // match replaces the cached value, so it is handed out as a const rvalue
+        // and the Ids bound to it take a copy.
+        template <typename Subject, typename Unary>
+        class Memo
+        {
+        public:
+            using ResultT = std::invoke_result_t<Unary const &, Subject const &>;
+
+            constexpr explicit Memo(Unary const &unary) : mUnary{unary} {}
+            Memo(Memo const &) = delete;
+            Memo &operator=(Memo const &) = delete;
+
+            decltype(auto) operator()(Subject const &subject) const
+            {
+                auto const key = static_cast<void const *>(std::addressof(subject));
+                if (mKey != key)
+                {
+                    if constexpr (std::is_reference_v<ResultT>)
+                    {
+                        mStored = std::addressof(project(mUnary, subject));
+                    }
+                    else
+                    {
+                        mStored.emplace(project(mUnary, subject));
+                    }
+                    mKey = key;
+                }
+                if constexpr (std::is_reference_v<ResultT>)
+                {
+                    return static_cast<ResultT>(*mStored);
+                }
+                else
+                {
+                    return std::move(std::as_const(*mStored));
+                }
+            }
+            // a temporary, like the projection of another arm, may take the address
+            // of the one cached before, its result would be reused.
+            void operator()(Subject &&) const = delete;
+            // the cached value stays alive for bindings into it, only the key is dropped.
+            constexpr void forget() const { mKey = nullptr; }
+
+        private:
+            using StoredT = std::conditional_t<std::is_reference_v<ResultT>,
+                                               std::remove_reference_t<ResultT> *,
+                                               std::optional<ResultT>>;
+            Unary mUnary;
+            mutable void const *mKey = nullptr;
+            mutable StoredT mStored{};
+        };
+
+        template <typename Subject, typename Unary>
+        constexpr auto memo(Unary const &unary)
+        {
+            return Memo<Subject, Unary>{unary};
+        }
+
+        template <typename T>
+        constexpr bool isMemoV = false;
+
+        template <typename Subject, typename Unary>
+        constexpr bool isMemoV<Memo<Subject, Unary>> = true;
+
+        template <typename T>
+        constexpr bool isConstRvalueV =
+            std::is_rvalue_reference_v<T> && std::is_const_v<std::remove_reference_t<T>>;
+
+        template <typename Unary, typename Pattern>
+        class PatternTraits<App<Unary, Pattern>>
         {
         public:
             template <typename Value>
             using AppResult = std::invoke_result_t<Unary, Value>;
             // We store value for scalar types in Id and they can not be moved. So to
-            // support constexpr.
+            // support constexpr. Const rvalues, as handed out by memos, can only be
+            // copied, they are passed on like lvalues.
             template <typename Value>
             using AppResultCurTuple =
                 std::conditional_t<std::is_lvalue_reference_v<AppResult<Value>> ||
+                                       isConstRvalueV<AppResult<Value>> ||
                                        std::is_scalar_v<AppResult<Value>>,
                                    std::tuple<>,
                                    std::tuple<std::decay_t<AppResult<Value>>>>;
@@ -589,6 +1300,13 @@ namespace matchit
             constexpr static void processIdImpl(App<Unary, Pattern> const &appPat,
                                                 int32_t depth, IdProcess idProcess)
             {
+                if constexpr (isMemoV<std::decay_t<Unary>>)
+                {
+                    if (idProcess == IdProcess::kFORGET)
+                    {
+                        appPat.unary().forget();
+                    }
+                }
                 return processId(appPat.pattern(), depth, idProcess);
             }
         };
@@ -720,16 +1438,11 @@ namespace matchit
         {
         };
 
-        template <typename Type>
-        using ValueVariant =
-            std::conditional_t<std::is_abstract_v<Type>,
-                               std::variant<std::monostate, Type const *>,
-                               std::variant<std::monostate, Type, Type const *>>;
-
+        // Bind lvalues by address, everything else by copy.
         template <typename Type, typename Value>
         struct StorePointer<Type, Value,
-                            std::void_t<decltype(std::declval<ValueVariant<Type> &>() =
-                                                     &std::declval<Value>())>>
+                            std::void_t<decltype(static_cast<Type const *>(
+                                &std::declval<Value>()))>>
             : std::conjunction<std::is_lvalue_reference<Value>,
                                std::negation<std::is_scalar<Value>>>
         {
@@ -754,7 +1467,7 @@ namespace matchit
             return Overload<Ts...>{ts...};
         }
 
-        template <typename Pattern>
+        template <typename Pattern, typename Storage>
         class OooBinder;
 
         class Ooo;
@@ -775,95 +1488,225 @@ namespace matchit
             }
         };
 
-        template <typename Type>
+        template <typename Type, typename Storage>
         class Id
         {
         private:
+            using StorageT = typename BaseStorage<Storage>::type;
+            constexpr static bool kPER_CALL = !std::is_same_v<StorageT, Storage>;
+
+            // mPtr points to the bound value, either outside or to the copy in mOwned,
+            // so reading a binding is a single load. mBound is kept apart from mPtr
+            // since gcc cannot compare the address of a subobject with nullptr in
+            // constant expressions. mOwned comes last so that a ByRef Id, its block
+            // and the pointer to it, stays three words wide.
             class Block
             {
             public:
-                ValueVariant<Type> mVariant;
-                int32_t mDepth;
-
-                constexpr auto &variant() { return mVariant; }
-                constexpr auto hasValue() const
-                {
-                    return std::visit(overload([](Type const &)
-                                               { return true; },
-                                               [](Type const *)
-                                               { return true; },
-                                               [](std::monostate const &)
-                                               { return false; }),
-                                      mVariant);
-                }
-                constexpr decltype(auto) value() const
-                {
-                    return std::visit(
-                        overload([](Type const &v) -> Type const & { return v; },
-                                 [](Type const *p) -> Type const & { return *p; },
-                                 [](std::monostate const &) -> Type const & {
-                                     throw std::logic_error("invalid state!");
-                                 }),
-                        mVariant);
-                }
-
-                constexpr decltype(auto) mutableValue()
-                {
-                    return std::visit(
-                        overload([](Type &v) -> Type & { return v; },
-                                 [](Type const *) -> Type & {
-                                     throw std::logic_error(
-                                         "Cannot get mutableValue for pointer type!");
-                                 },
-                                 [](std::monostate &) -> Type & {
-                                     throw std::logic_error("Invalid state!");
-                                 }),
-                        mVariant);
-                }
-                constexpr void reset(int32_t depth)
+                using OwnedT =
+                    std::conditional_t<std::is_abstract_v<Type> || std::is_same_v<StorageT, ByRef>,
+                                       std::monostate, std::optional<std::remove_const_t<Type>>>;
+                constexpr static bool kOWNS = !std::is_same_v<OwnedT, std::monostate>;
+
+                Type const *mPtr = nullptr;
+                int32_t mDepth = 0;
+                bool mBound = false;
+                // bound by address into the temporary subject of the match, and
+                // whether that part may be moved from.
+                bool mInSubject = false;
+                bool mMovable = false;
+                OwnedT mOwned{};
+
+                constexpr Block() = default;
+                Block(Block const &) = delete;
+                Block &operator=(Block const &) = delete;
+
+                constexpr bool hasValue() const { return mBound; }
+                constexpr Type const &value() const
                 {
-                    if (mDepth - depth >= 0)
+                    if (!mBound)
                     {
-                        mVariant = {};
-                        mDepth = depth;
+                        throw std::logic_error("invalid state!");
                     }
+                    return *mPtr;
                 }
-                constexpr void confirm(int32_t depth)
+                constexpr Type &mutableValue()
                 {
-                    if (mDepth > depth || mDepth == 0)
+                    if (!mBound)
                     {
-                        assert(depth == mDepth - 1 || depth == mDepth || mDepth == 0);
-                        mDepth = depth;
+                        throw std::logic_error("Invalid state!");
+                    }
+                    if constexpr (!kOWNS)
+                    {
+                        throw std::logic_error("Cannot get mutableValue for pointer type!");
+                    }
+                    else
+                    {
+                        // the handler of an arm that matched a temporary subject.
+                        if (mMovable)
+                        {
+                            return const_cast<Type &>(*mPtr);
+                        }
+                        if (!mOwned.has_value())
+                        {
+                            throw std::logic_error("Cannot get mutableValue for pointer type!");
+                        }
+                        return *mOwned;
                     }
-                }
-            };
-            class IdUtil
-            {
-            public:
-                template <typename Value>
-                constexpr static auto bindValue(ValueVariant<Type> &v, Value &&value,
-                                                     std::false_type /* StorePointer */)
-                {
-                    // for constexpr
-                    v = ValueVariant<Type>{std::forward<Value>(value)};
                 }
                 template <typename Value>
-                constexpr static auto bindValue(ValueVariant<Type> &v, Value &&value,
-                                                     std::true_type /* StorePointer */)
+                constexpr void bind(Value &&value, std::false_type /* StorePointer */)
                 {
-                    v = ValueVariant<Type>{&value};
+                    // assigned rather than emplaced where possible, for constexpr.
+                    if constexpr (std::is_move_assignable_v<OwnedT>)
+                    {
+                        mOwned = OwnedT{std::forward<Value>(value)};
+                    }
+                    else
+                    {
+                        mOwned.emplace(std::forward<Value>(value));
+                    }
+                    mPtr = &*mOwned;
+                    mBound = true;
+                }
+                template <typename Value>
+                constexpr void bind(Value &&value, std::true_type /* StorePointer */,
+                                    OwnedSubject const &subject)
+                {
+                    mInSubject = subject.mUnknown || subject.contains(std::addressof(value));
+                    if constexpr (std::is_same_v<StorageT, ByValue>)
+                    {
+                        // only the parts of a temporary subject are moved in later.
+                        if (!mInSubject)
+                        {
+                            bind(value, std::false_type{});
+                            return;
+                        }
+                    }
+                    mPtr = &value;
+                    mBound = true;
+                    mMovable = mInSubject && !subject.mUnknown &&
+                               !std::is_const_v<std::remove_reference_t<Value>>;
+                    if (mInSubject && !subject.mUnknown)
+                    {
+                        subject.addPart(std::addressof(value),
+                                        sizeof(std::remove_reference_t<Value>), &mMovable);
+                    }
+                }
+                template <typename Value>
+                constexpr void bind(Value &&value, std::false_type storePointer,
+                                    OwnedSubject const &)
+                {
+                    bind(std::forward<Value>(value), storePointer);
+                }
+                // The handler of the arm returned, what is bound inside the temporary
+                // subject is moved, or copied if const or bound again later, into
+                // mOwned. Parts that
+                // can be neither are left bound by address.
+                constexpr void own()
+                {
+                    if constexpr (kOWNS)
+                    {
+                        if (mInSubject)
+                        {
+                            if (mMovable)
+                            {
+                                bind(std::move(const_cast<Type &>(*mPtr)), std::false_type{});
+                            }
+                            else if constexpr (std::is_copy_constructible_v<Type>)
+                            {
+                                bind(*mPtr, std::false_type{});
+                            }
+                        }
+                    }
+                    mInSubject = false;
+                    mMovable = false;
+                }
+                constexpr void reset(int32_t depth)
+                {
+                    if (mDepth - depth >= 0)
+                    {
+                        mPtr = nullptr;
+                        mBound = false;
+                        mInSubject = false;
+                        mMovable = false;
+                        if constexpr (kOWNS)
+                        {
+                            if (mOwned.has_value())
+                            {
+                                if constexpr (std::is_move_assignable_v<OwnedT>)
+                                {
+                                    mOwned = OwnedT{};
+                                }
+                                else
+                                {
+                                    mOwned.reset();
+                                }
+                            }
+                        }
+                        mDepth = depth;
+                    }
+                }
+                constexpr void confirm(int32_t depth)
+                {
+                    if (mDepth > depth || mDepth == 0)
+                    {
+                        assert(depth == mDepth - 1 || depth == mDepth || mDepth == 0);
+                        mDepth = depth;
+                    }
                 }
             };
 
-            using BlockVT = std::variant<Block, Block *>;
-            BlockVT mBlock = Block{};
+            // An Id owns mInline, copies share the block of the Id they copy.
+            Block mInline{};
+            Block *mBlock = &mInline;
+
+            // The block of the current call, for a PerCall Id. Its slot is kept as a
+            // negative depth. Outside of a call it stays unbound.
+            Block &slotBlock() const
+            {
+                auto const slot = static_cast<std::size_t>(-(mBlock->mDepth + 1));
+                for (auto frame = bindingFrame(); frame != nullptr; frame = frame->mOuter)
+                {
+                    if (slot < frame->mNbIds && frame->mSlots[slot] == mBlock)
+                    {
+                        return *static_cast<Block *>(frame->mBlocks[slot]);
+                    }
+                }
+                return *mBlock;
+            }
+
+            template <typename Builder, typename... Ids>
+            friend class BindingMatcher;
 
             constexpr Type const &internalValue() const { return block().value(); }
 
+            template <typename Value>
+            constexpr static auto storePointer()
+            {
+                if constexpr (std::is_same_v<StorageT, ByValue>)
+                {
+                    return std::false_type{};
+                }
+                else
+                {
+                    static_assert(!std::is_same_v<StorageT, ByRef> ||
+                                      StorePointer<Type, Value>::value,
+                                  "Id<T, ByRef> can only bind lvalues, "
+                                  "use Id<T> or Id<T, ByValue> to bind temporaries.");
+                    return StorePointer<Type, Value>{};
+                }
+            }
+
         public:
             constexpr Id() = default;
 
-            constexpr Id(Id const &id) { mBlock = BlockVT{&id.block()}; }
+            constexpr Id(Id const &id) : mBlock{id.mBlock} {}
+            constexpr Id &operator=(Id const &id)
+            {
+                mBlock = id.mBlock;
+                return *this;
+            }
 
             // non-const to inform users not to mark Id as const.
             template <typename Pattern>
@@ -873,41 +1716,48 @@ namespace matchit
             }
 
             // non-const to inform users not to mark Id as const.
-            constexpr auto at(Ooo const &) { return OooBinder<Type>{*this}; }
+            constexpr auto at(Ooo const &) { return OooBinder<Type, Storage>{*this}; }
 
             constexpr Block &block() const
             {
-                return std::visit(overload([](Block &v) -> Block & { return v; },
-                                           [](Block *p) -> Block & { return *p; }),
-                                  // constexpr does not allow mutable, we use const_cast
-                                  // instead. Never declare Id as const.
-                                  const_cast<BlockVT &>(mBlock));
+                if constexpr (kPER_CALL)
+                {
+                    return slotBlock();
+                }
+                else
+                {
+                    return *mBlock;
+                }
             }
 
             template <typename Value>
             constexpr auto
-                matchValue(Value &&v) const
+                matchValue(Value &&v, OwnedSubject const &subject = {}) const
             {
                 if (hasValue())
                 {
                     return IdTraits<Type>::equal(internalValue(), v);
                 }
-                IdUtil::bindValue(block().variant(), std::forward<Value>(v),
-                                   StorePointer<Type, Value>{});
+                block().bind(std::forward<Value>(v), storePointer<Value>(), subject);
                 return true;
             }
             constexpr void reset(int32_t depth) const { return block().reset(depth); }
             constexpr void confirm(int32_t depth) const { return block().confirm(depth); }
+            constexpr void own() const { return block().own(); }
             constexpr bool hasValue() const { return block().hasValue(); }
             // non-const to inform users not to mark Id as const.
             constexpr Type const &value() { return block().value(); }
             // non-const to inform users not to mark Id as const.
             constexpr Type const &operator*() { return value(); }
+            // The owned copy, taken from the subject when it was a temporary.
             constexpr Type &&move() { return std::move(block().mutableValue()); }
+
+            // ByRef Ids and Ids of abstract types can only refer to what they bind.
+            constexpr static bool kOWNS = Block::kOWNS;
         };
 
-        template <typename Type>
-        class PatternTraits<Id<Type>>
+        template <typename Type, typename Storage>
+        class PatternTraits<Id<Type, Storage>>
         {
         public:
             template <typename Value>
@@ -916,12 +1766,15 @@ namespace matchit
             constexpr static auto nbIdV = true;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value, Id<Type> const &idPat,
-                                                   int32_t /* depth */, ContextT &)
+            constexpr static auto matchPatternImpl(Value &&value, Id<Type, Storage> const &idPat,
+                                                   int32_t /* depth */, ContextT &context)
             {
-                return idPat.matchValue(std::forward<Value>(value));
+                static_assert(Id<Type, Storage>::kOWNS || !bindsIntoTemporaryV<ContextT>,
+                              "Id<T, ByRef> and Ids of abstract types would outlive a "
+                              "temporary subject, match an lvalue or use Id<T>.");
+                return idPat.matchValue(std::forward<Value>(value), ownedSubject(context));
             }
-            constexpr static void processIdImpl(Id<Type> const &idPat, int32_t depth,
+            constexpr static void processIdImpl(Id<Type, Storage> const &idPat, int32_t depth,
                                                 IdProcess idProcess)
             {
                 switch (idProcess)
@@ -933,10 +1786,28 @@ namespace matchit
                 case IdProcess::kCONFIRM:
                     idPat.confirm(depth);
                     break;
+
+                case IdProcess::kOWN:
+                    idPat.own();
+                    break;
+
+                case IdProcess::kFORGET:
+                    break;
                 }
             }
         };
 
+        template <typename Pattern>
+        constexpr auto isIntegralLiteralV =
+            std::is_integral_v<Pattern> && !std::is_same_v<Pattern, bool>;
+
+        // An integral literal equals an integral element iff it equals the literal
+        // converted to the element type, so runs of them compare as bytes.
+        template <typename Pattern, typename Elem>
+        constexpr auto isByteLiteralV =
+            isIntegralLiteralV<Pattern> && isIntegralLiteralV<Elem> &&
+            std::has_unique_object_representations_v<Elem>;
+
         template <typename... Patterns>
         class Ds
         {
@@ -971,23 +1842,23 @@ namespace matchit
             return Ds<Patterns...>{patterns...};
         }
 
-        template <typename T>
+        template <typename T, typename Storage>
         class OooBinder
         {
-            Id<T> mId;
+            Id<T, Storage> mId;
 
         public:
-            OooBinder(Id<T> const &id) : mId{id} {}
+            OooBinder(Id<T, Storage> const &id) : mId{id} {}
             decltype(auto) binder() const { return mId; }
         };
 
         class Ooo
         {
         public:
-            template <typename T>
-            constexpr auto operator()(Id<T> id) const
+            template <typename T, typename Storage>
+            constexpr auto operator()(Id<T, Storage> id) const
             {
-                return OooBinder<T>{id};
+                return OooBinder<T, Storage>{id};
             }
         };
 
@@ -1011,8 +1882,8 @@ namespace matchit
             constexpr static void processIdImpl(Ooo, int32_t /*depth*/, IdProcess) {}
         };
 
-        template <typename Pattern>
-        class PatternTraits<OooBinder<Pattern>>
+        template <typename Pattern, typename Storage>
+        class PatternTraits<OooBinder<Pattern, Storage>>
         {
         public:
             template <typename Value>
@@ -1023,13 +1894,13 @@ namespace matchit
 
             template <typename Value, typename ContextT>
             constexpr static auto matchPatternImpl(Value &&value,
-                                                   OooBinder<Pattern> const &oooBinderPat,
+                                                   OooBinder<Pattern, Storage> const &oooBinderPat,
                                                    int32_t depth, ContextT &context)
             {
                 return matchPattern(std::forward<Value>(value), oooBinderPat.binder(),
                                     depth + 1, context);
             }
-            constexpr static void processIdImpl(OooBinder<Pattern> const &oooBinderPat,
+            constexpr static void processIdImpl(OooBinder<Pattern, Storage> const &oooBinderPat,
                                                 int32_t depth, IdProcess idProcess)
             {
                 processId(oooBinderPat.binder(), depth, idProcess);
@@ -1051,8 +1922,8 @@ namespace matchit
         {
         };
 
-        template <typename T>
-        class IsOooBinder<OooBinder<T>> : public std::true_type
+        template <typename T, typename Storage>
+        class IsOooBinder<OooBinder<T, Storage>> : public std::true_type
         {
         };
 
@@ -1091,8 +1962,135 @@ namespace matchit
             findOooIdx<std::tuple<int32_t, OooBinder<int32_t>, const char *>>() == 1);
         static_assert(findOooIdx<std::tuple<int32_t, Ooo, const char *>>() == 1);
 
+        // memcmp is not usable in constant evaluation, without a way to tell we
+        // always take the element by element path.
+        constexpr bool isConstantEvaluated()
+        {
+#if defined(__cpp_lib_is_constant_evaluated)
+            return std::is_constant_evaluated();
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+            return __builtin_is_constant_evaluated();
+#else
+            return true;
+#endif
+#else
+            return true;
+#endif
+        }
+
+        template <typename Range, typename = std::void_t<>>
+        struct ContiguousElem
+        {
+            using type = void;
+        };
+
+        template <typename Range>
+        struct ContiguousElem<Range, std::void_t<decltype(std::data(std::declval<Range &>()))>>
+        {
+        private:
+            using PointerT = decltype(std::data(std::declval<Range &>()));
+            using ElemT = std::remove_cv_t<std::remove_pointer_t<PointerT>>;
+
+        public:
+            using type = std::conditional_t<
+                std::is_pointer_v<PointerT> &&
+                    std::is_same_v<ElemT, std::decay_t<decltype(*std::begin(
+                                              std::declval<Range &>()))>>,
+                ElemT, void>;
+        };
+
+        // The element type of ranges stored contiguously, void for others.
+        template <typename Range>
+        using ContiguousElemT = typename ContiguousElem<std::remove_reference_t<Range>>::type;
+
+        static_assert(std::is_same_v<ContiguousElemT<std::array<char, 4>>, char>);
+
+        // Patterns that are byte literals for Checked were already compared in bulk.
+        template <typename Checked, typename Value, typename Pattern, typename ContextT>
+        constexpr bool matchElement(Value &&value, Pattern const &pattern, int32_t depth,
+                                    ContextT &context)
+        {
+            if constexpr (isByteLiteralV<Pattern, Checked>)
+            {
+                return true;
+            }
+            else
+            {
+                return matchPattern(std::forward<Value>(value), pattern, depth, context);
+            }
+        }
+
+        template <typename PatternTuple, std::size_t... I>
+        constexpr std::size_t literalRunLengthImpl(std::size_t idx, std::size_t end,
+                                                   std::index_sequence<I...>)
+        {
+            constexpr bool isLiteral[] = {
+                isIntegralLiteralV<std::tuple_element_t<I, PatternTuple>>..., false};
+            std::size_t len = 0;
+            while (idx + len < end && isLiteral[idx + len])
+            {
+                ++len;
+            }
+            return len;
+        }
+
+        template <typename PatternTuple>
+        constexpr std::size_t literalRunLength(std::size_t idx, std::size_t end)
+        {
+            return literalRunLengthImpl<PatternTuple>(
+                idx, end, std::make_index_sequence<std::tuple_size_v<PatternTuple>>{});
+        }
+
+        template <typename Elem, typename Pattern>
+        constexpr bool equalsConverted(Pattern const &pattern)
+        {
+            using CommonT = decltype(pattern + Elem{});
+            return static_cast<CommonT>(pattern) ==
+                   static_cast<CommonT>(static_cast<Elem>(pattern));
+        }
+
+        // Literals are converted at each comparison, for patterns built per match the
+        // conversions fold into constants.
+        template <std::size_t start, std::size_t... I, typename Elem, typename PatternTuple>
+        bool compareLiterals(Elem const *data, PatternTuple const &patternTuple,
+                             std::index_sequence<I...>)
+        {
+            Elem const literals[] = {static_cast<Elem>(std::get<start + I>(patternTuple))...};
+            // a literal out of the element range equals no element.
+            return (equalsConverted<Elem>(std::get<start + I>(patternTuple)) && ...) &&
+                   std::memcmp(data, literals, sizeof(literals)) == 0;
+        }
+
+        // Compares the integral literals among patterns [idx, end) against data, one
+        // memcmp per run of consecutive literals.
+        template <std::size_t idx, std::size_t end, typename Elem, typename PatternTuple>
+        bool compareLiteralRuns(Elem const *data, PatternTuple const &patternTuple)
+        {
+            if constexpr (idx == end)
+            {
+                static_cast<void>(data);
+                static_cast<void>(patternTuple);
+                return true;
+            }
+            else
+            {
+                constexpr auto runLen = literalRunLength<PatternTuple>(idx, end);
+                if constexpr (runLen == 0)
+                {
+                    return compareLiteralRuns<idx + 1, end>(data + 1, patternTuple);
+                }
+                else
+                {
+                    return compareLiterals<idx>(data, patternTuple,
+                                                std::make_index_sequence<runLen>{}) &&
+                           compareLiteralRuns<idx + runLen, end>(data + runLen, patternTuple);
+                }
+            }
+        }
+
         using std::get;
-        template <std::size_t valueStartIdx, std::size_t patternStartIdx,
+        template <std::size_t valueStartIdx, std::size_t patternStartIdx, typename Checked,
                   std::size_t... I, typename ValueTuple, typename PatternTuple,
                   typename ContextT>
         constexpr decltype(auto)
@@ -1100,10 +2098,10 @@ namespace matchit
                                  int32_t depth, ContextT &context,
                                  std::index_sequence<I...>)
         {
-            auto const func = [&](auto &&value, auto &&pattern)
+            auto const func = [&](auto &&value, auto const &pattern)
             {
-                return matchPattern(std::forward<decltype(value)>(value), pattern,
-                                    depth + 1, context);
+                return matchElement<Checked>(std::forward<decltype(value)>(value), pattern,
+                                             depth + 1, context);
             };
             static_cast<void>(func);
             return (func(get<I + valueStartIdx>(std::forward<ValueTuple>(valueTuple)),
@@ -1112,45 +2110,41 @@ namespace matchit
         }
 
         template <std::size_t valueStartIdx, std::size_t patternStartIdx,
-                  std::size_t size, typename ValueTuple, typename PatternTuple,
-                  typename ContextT>
+                  std::size_t size, typename Checked = void, typename ValueTuple,
+                  typename PatternTuple, typename ContextT>
         constexpr decltype(auto)
         matchPatternMultiple(ValueTuple &&valueTuple, PatternTuple &&patternTuple,
                              int32_t depth, ContextT &context)
         {
-            return matchPatternMultipleImpl<valueStartIdx, patternStartIdx>(
+            return matchPatternMultipleImpl<valueStartIdx, patternStartIdx, Checked>(
                 std::forward<ValueTuple>(valueTuple), patternTuple, depth, context,
                 std::make_index_sequence<size>{});
         }
 
-        template <std::size_t patternStartIdx, std::size_t... I, typename RangeBegin,
-                  typename PatternTuple, typename ContextT>
-        constexpr decltype(auto) matchPatternRangeImpl(RangeBegin &&rangeBegin,
-                                                       PatternTuple &&patternTuple,
-                                                       int32_t depth, ContextT &context,
-                                                       std::index_sequence<I...>)
+        // Walks the range once, iter is left after the last matched element.
+        template <std::size_t patternStartIdx, typename Checked, std::size_t... I,
+                  typename Iter, typename PatternTuple, typename ContextT>
+        constexpr bool matchPatternRangeImpl(Iter &iter, PatternTuple const &patternTuple,
+                                             int32_t depth, ContextT &context,
+                                             std::index_sequence<I...>)
         {
-            auto const func = [&](auto &&value, auto &&pattern)
+            auto const func = [&](auto const &pattern)
             {
-                return matchPattern(std::forward<decltype(value)>(value), pattern,
-                                    depth + 1, context);
+                auto const matched = matchElement<Checked>(*iter, pattern, depth + 1, context);
+                ++iter;
+                return matched;
             };
             static_cast<void>(func);
-            // Fix Me, avoid call next from begin every time.
-            return (func(*std::next(rangeBegin, static_cast<long>(I)),
-                         std::get<I + patternStartIdx>(patternTuple)) &&
-                    ...);
+            return (func(std::get<I + patternStartIdx>(patternTuple)) && ...);
         }
 
-        template <std::size_t patternStartIdx, std::size_t size,
-                  typename ValueRangeBegin, typename PatternTuple, typename ContextT>
-        constexpr decltype(auto) matchPatternRange(ValueRangeBegin &&valueRangeBegin,
-                                                   PatternTuple &&patternTuple,
-                                                   int32_t depth, ContextT &context)
+        template <std::size_t patternStartIdx, std::size_t size, typename Checked = void,
+                  typename Iter, typename PatternTuple, typename ContextT>
+        constexpr bool matchPatternRange(Iter &iter, PatternTuple const &patternTuple,
+                                         int32_t depth, ContextT &context)
         {
-            return matchPatternRangeImpl<patternStartIdx>(
-                valueRangeBegin, patternTuple, depth, context,
-                std::make_index_sequence<size>{});
+            return matchPatternRangeImpl<patternStartIdx, Checked>(
+                iter, patternTuple, depth, context, std::make_index_sequence<size>{});
         }
 
         template <std::size_t start, typename Indices, typename Tuple>
@@ -1246,114 +2240,448 @@ namespace matchit
         static_assert(!isRangeV<std::pair<int32_t, char>>);
         static_assert(isRangeV<const std::array<int32_t, 5>>);
 
-        template <typename... Patterns>
-        class PatternTraits<Ds<Patterns...>>
+        template <typename Iter, typename = std::void_t<>>
+        struct IteratorCategory
         {
-            constexpr static auto nbOooOrBinder = nbOooOrBinderV<Patterns...>;
-            static_assert(nbOooOrBinder == 0 || nbOooOrBinder == 1);
-
-        public:
-            template <typename PsTuple, typename VsTuple>
-            class PairPV;
+            using type = std::input_iterator_tag;
+        };
 
-            template <typename... Ps, typename... Vs>
-            class PairPV<std::tuple<Ps...>, std::tuple<Vs...>>
-            {
-            public:
-                using type = decltype(std::tuple_cat(
-                    std::declval<
-                        typename PatternTraits<Ps>::template AppResultTuple<Vs>>()...));
-            };
+        template <typename Iter>
+        struct IteratorCategory<
+            Iter, std::void_t<typename std::iterator_traits<Iter>::iterator_category>>
+        {
+            using type = typename std::iterator_traits<Iter>::iterator_category;
+        };
 
-            template <std::size_t nbOoos, typename ValueTuple>
-            class AppResultForTupleHelper;
+        template <typename Iter>
+        constexpr auto isMultiPassV =
+            std::is_base_of_v<std::forward_iterator_tag, typename IteratorCategory<Iter>::type>;
 
-            template <typename... Values>
-            class AppResultForTupleHelper<0, std::tuple<Values...>>
-            {
-            public:
-                using type = decltype(std::tuple_cat(
-                    std::declval<typename PatternTraits<Patterns>::template AppResultTuple<
-                        Values>>()...));
-            };
+        template <typename Range, typename = std::void_t<>>
+        struct HasSize : std::false_type
+        {
+        };
 
-            template <typename... Values>
-            class AppResultForTupleHelper<1, std::tuple<Values...>>
-            {
-                constexpr static auto idxOoo = findOooIdx<typename Ds<Patterns...>::Type>();
-                using Ps0 = SubTypesT<0, idxOoo, std::tuple<Patterns...>>;
-                using Vs0 = SubTypesT<0, idxOoo, std::tuple<Values...>>;
-                constexpr static auto isBinder =
-                    isOooBinderV<std::tuple_element_t<idxOoo, std::tuple<Patterns...>>>;
-                // <0, ...int32_t> to workaround compile failure for std::tuple<>.
-                using ElemT = std::tuple_element_t<
-                    0, std::tuple<std::remove_reference_t<Values>..., int32_t>>;
-                constexpr static int64_t diff =
-                    static_cast<int64_t>(sizeof...(Values) - sizeof...(Patterns));
-                constexpr static size_t clippedDiff =
-                    static_cast<size_t>(diff > 0 ? diff : 0);
-                using OooResultTuple = typename std::conditional<
-                    isBinder, std::tuple<SubrangeT<std::array<ElemT, clippedDiff>>>,
-                    std::tuple<>>::type;
-                using FirstHalfTuple = typename PairPV<Ps0, Vs0>::type;
-                using Ps1 =
-                    SubTypesT<idxOoo + 1, sizeof...(Patterns), std::tuple<Patterns...>>;
-                constexpr static auto vs1Start =
-                    static_cast<size_t>(static_cast<int64_t>(idxOoo) + 1 + diff);
-                using Vs1 = SubTypesT<vs1Start, sizeof...(Values), std::tuple<Values...>>;
-                using SecondHalfTuple = typename PairPV<Ps1, Vs1>::type;
+        template <typename Range>
+        struct HasSize<Range, std::void_t<decltype(std::declval<Range &>().size())>>
+            : std::true_type
+        {
+        };
 
-            public:
-                using type = decltype(std::tuple_cat(std::declval<FirstHalfTuple>(),
-                                                     std::declval<OooResultTuple>(),
-                                                     std::declval<SecondHalfTuple>()));
-            };
+        template <typename Range>
+        using RangeIterT = decltype(std::begin(std::declval<Range &>()));
 
-            template <typename Tuple>
-            using AppResultForTuple = typename AppResultForTupleHelper<
-                nbOooOrBinder, decltype(drop<0>(std::declval<Tuple>()))>::type;
+        // Ranges without size(), with a sentinel end, or with input-only iterators
+        // are matched in one pass without knowing their length.
+        template <typename Range>
+        constexpr auto isStreamingV =
+            !(HasSize<std::remove_reference_t<Range>>::value &&
+              isMultiPassV<RangeIterT<std::remove_reference_t<Range>>> &&
+              std::is_same_v<RangeIterT<std::remove_reference_t<Range>>,
+                             decltype(std::end(std::declval<Range &>()))>);
 
-            template <typename RangeType>
-            using RangeTuple =
-                std::conditional_t<nbOooOrBinder == 1, std::tuple<SubrangeT<RangeType>>,
-                                   std::tuple<>>;
+        static_assert(!isStreamingV<std::array<int32_t, 4> const &>);
 
-            template <typename RangeType>
-            using AppResultForRangeType = decltype(std::tuple_cat(
-                std::declval<RangeTuple<RangeType>>(),
-                std::declval<typename PatternTraits<Patterns>::template AppResultTuple<
-                    decltype(*std::begin(std::declval<RangeType>()))>>()...));
+        // Elements of input-only ranges are handed over as values, the increment
+        // invalidates what operator* returned.
+        template <typename Iter>
+        constexpr decltype(auto) streamElement(Iter const &iter)
+        {
+            if constexpr (isMultiPassV<Iter>)
+            {
+                return *iter;
+            }
+            else
+            {
+                return std::decay_t<decltype(*iter)>(*iter);
+            }
+        }
 
-            template <typename Value, typename = std::void_t<>>
-            class AppResultHelper;
+        // The elements of an input-only range that the arms of a match read, kept
+        // so that every arm reads the range from its start. Each element is read
+        // from the range once, by the first arm that gets to it. The first
+        // nbPrefix elements stay in place for the Ids bound to them, the ooo span
+        // streams through a ring that keeps the last nbSuffix.
+        template <typename Range, std::size_t nbPrefix, std::size_t nbSuffix>
+        class StreamBuffer
+        {
+            using SourceT = RangeIterT<Range>;
+            using SentinelT = decltype(std::end(std::declval<Range &>()));
+            using ElemT = std::decay_t<decltype(*std::declval<SourceT const &>())>;
+            static_assert(std::is_default_constructible_v<ElemT>,
+                          "Several arms reading an input range buffer elements that must be "
+                          "default constructible.");
 
-            template <typename Value>
-            class AppResultHelper<Value, std::enable_if_t<isTupleLikeV<Value>>>
+        public:
+            class Iterator
             {
             public:
-                using type = AppResultForTuple<Value>;
-            };
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = ElemT;
+                using difference_type = std::ptrdiff_t;
+                using pointer = ElemT const *;
+                using reference = ElemT const &;
+
+                Iterator() = default;
+                Iterator(StreamBuffer const *buffer, std::size_t idx) : mBuffer{buffer}, mIdx{idx} {}
+                reference operator*() const { return mBuffer->at(mIdx); }
+                pointer operator->() const { return &mBuffer->at(mIdx); }
+                Iterator &operator++()
+                {
+                    ++mIdx;
+                    return *this;
+                }
+                Iterator operator++(int)
+                {
+                    auto const old = *this;
+                    ++mIdx;
+                    return old;
+                }
+                // the end iterator has no buffer.
+                friend bool operator==(Iterator const &lhs, Iterator const &rhs)
+                {
+                    auto const lhsEnd = lhs.atEnd();
+                    auto const rhsEnd = rhs.atEnd();
+                    return lhsEnd || rhsEnd ? lhsEnd == rhsEnd : lhs.mIdx == rhs.mIdx;
+                }
+                friend bool operator!=(Iterator const &lhs, Iterator const &rhs)
+                {
+                    return !(lhs == rhs);
+                }
 
-            template <typename RangeType>
-            class AppResultHelper<RangeType, std::enable_if_t<!isTupleLikeV<RangeType> &&
-                                                              isRangeV<RangeType>>>
-            {
-            public:
-                using type = AppResultForRangeType<RangeType>;
-            };
+            private:
+                bool atEnd() const { return mBuffer == nullptr || !mBuffer->read(mIdx); }
 
-            template <typename Value>
-            using AppResultTuple = typename AppResultHelper<Value>::type;
+                StreamBuffer const *mBuffer = nullptr;
+                std::size_t mIdx = 0;
+            };
 
-            constexpr static auto nbIdV = (PatternTraits<Patterns>::nbIdV + ... + 0);
+            explicit StreamBuffer(Range &range)
+                : mNext{std::begin(range)}, mEnd{std::end(range)}
+            {
+            }
+            StreamBuffer(StreamBuffer const &) = delete;
+            StreamBuffer &operator=(StreamBuffer const &) = delete;
+            Iterator begin() const { return Iterator{this, 0}; }
+            Iterator end() const { return Iterator{}; }
 
-            template <typename ValueTuple, typename ContextT>
+        private:
+            // Reads up to element idx, false if the range ends before it. The source
+            // is advanced only when the next element is needed.
+            bool read(std::size_t idx) const
+            {
+                while (mNbRead <= idx)
+                {
+                    if (mEnded)
+                    {
+                        return false;
+                    }
+                    if (mNbRead != 0)
+                    {
+                        ++mNext;
+                    }
+                    if (mNext == mEnd)
+                    {
+                        mEnded = true;
+                        return false;
+                    }
+                    if (mNbRead < nbPrefix)
+                    {
+                        mPrefix[mNbRead] = *mNext;
+                    }
+                    else if constexpr (nbSuffix != 0)
+                    {
+                        mRing[(mNbRead - nbPrefix) % nbSuffix] = *mNext;
+                    }
+                    ++mNbRead;
+                }
+                return true;
+            }
+            // arms read the elements of their prefix, and of their suffix once the
+            // range is read to its end.
+            ElemT const &at(std::size_t idx) const
+            {
+                if constexpr (nbSuffix != 0)
+                {
+                    if (idx >= nbPrefix)
+                    {
+                        assert(mNbRead - idx <= nbSuffix);
+                        return mRing[(idx - nbPrefix) % nbSuffix];
+                    }
+                }
+                return mPrefix[idx];
+            }
+
+            // filled as the arms read on.
+            mutable SourceT mNext;
+            SentinelT mEnd;
+            mutable std::size_t mNbRead = 0;
+            mutable bool mEnded = false;
+            mutable std::array<ElemT, nbPrefix> mPrefix{};
+            mutable std::array<ElemT, nbSuffix> mRing{};
+        };
+
+        template <typename Value>
+        constexpr bool isInputOnlyRange()
+        {
+            if constexpr (isRangeV<Value>)
+            {
+                return !isMultiPassV<RangeIterT<std::remove_reference_t<Value>>>;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        // The elements an arm reads at the start of a range, and at its end after
+        // ooo. Only ds patterns that do not bind ooo have a reach.
+        template <typename Pattern>
+        class StreamReach
+        {
+        public:
+            constexpr static auto kBOUNDED = std::is_same_v<Pattern, Wildcard>;
+            constexpr static std::size_t kPREFIX = 0;
+            constexpr static std::size_t kSUFFIX = 0;
+        };
+
+        template <typename... Patterns>
+        class StreamReach<Ds<Patterns...>>
+        {
+            constexpr static auto kSIZE = sizeof...(Patterns);
+            constexpr static auto kIDX_OOO = []
+            {
+                if constexpr (nbOooOrBinderV<Patterns...> == 0)
+                {
+                    return kSIZE;
+                }
+                else
+                {
+                    return findOooIdx<typename Ds<Patterns...>::Type>();
+                }
+            }();
+
+        public:
+            constexpr static auto kBOUNDED = (!isOooBinderV<Patterns> && ...);
+            constexpr static std::size_t kPREFIX = kIDX_OOO;
+            constexpr static std::size_t kSUFFIX = kIDX_OOO == kSIZE ? 0 : kSIZE - kIDX_OOO - 1;
+        };
+
+        template <typename Range>
+        using StreamElemT = decltype(streamElement(
+            std::declval<RangeIterT<std::remove_reference_t<Range>> const &>()));
+
+        template <std::size_t patternStartIdx, std::size_t... I, typename Iter,
+                  typename Sentinel, typename PatternTuple, typename ContextT>
+        constexpr bool matchPatternStreamImpl(Iter &iter, Sentinel const &end,
+                                              PatternTuple const &patternTuple, int32_t depth,
+                                              ContextT &context, std::index_sequence<I...>)
+        {
+            auto const func = [&](auto const &pattern)
+            {
+                if (iter == end)
+                {
+                    return false;
+                }
+                auto const matched =
+                    matchPattern(streamElement(iter), pattern, depth + 1, context);
+                ++iter;
+                return matched;
+            };
+            static_cast<void>(func);
+            return (func(std::get<I + patternStartIdx>(patternTuple)) && ...);
+        }
+
+        template <std::size_t patternStartIdx, std::size_t size, typename Iter,
+                  typename Sentinel, typename PatternTuple, typename ContextT>
+        constexpr bool matchPatternStream(Iter &iter, Sentinel const &end,
+                                          PatternTuple const &patternTuple, int32_t depth,
+                                          ContextT &context)
+        {
+            return matchPatternStreamImpl<patternStartIdx>(iter, end, patternTuple, depth,
+                                                           context,
+                                                           std::make_index_sequence<size>{});
+        }
+
+        // ring holds the last elements of the stream, the oldest at count % size.
+        template <std::size_t patternStartIdx, std::size_t... I, typename Ring,
+                  typename PatternTuple, typename ContextT>
+        constexpr bool matchPatternRing(Ring &ring, std::size_t count,
+                                        PatternTuple const &patternTuple, int32_t depth,
+                                        ContextT &context, std::index_sequence<I...>)
+        {
+            constexpr auto size = sizeof...(I);
+            static_cast<void>(count);
+            return (matchPattern(std::move(ring[(count + I) % size]),
+                                 std::get<I + patternStartIdx>(patternTuple), depth + 1,
+                                 context) &&
+                    ...);
+        }
+
+        template <typename... Patterns>
+        class PatternTraits<Ds<Patterns...>>
+        {
+            constexpr static auto nbOooOrBinder = nbOooOrBinderV<Patterns...>;
+            static_assert(nbOooOrBinder == 0 || nbOooOrBinder == 1);
+
+        public:
+            template <typename PsTuple, typename VsTuple>
+            class PairPV;
+
+            template <typename... Ps, typename... Vs>
+            class PairPV<std::tuple<Ps...>, std::tuple<Vs...>>
+            {
+            public:
+                using type = decltype(std::tuple_cat(
+                    std::declval<
+                        typename PatternTraits<Ps>::template AppResultTuple<Vs>>()...));
+            };
+
+            template <std::size_t nbOoos, typename ValueTuple>
+            class AppResultForTupleHelper;
+
+            template <typename... Values>
+            class AppResultForTupleHelper<0, std::tuple<Values...>>
+            {
+            public:
+                using type = decltype(std::tuple_cat(
+                    std::declval<typename PatternTraits<Patterns>::template AppResultTuple<
+                        Values>>()...));
+            };
+
+            template <typename... Values>
+            class AppResultForTupleHelper<1, std::tuple<Values...>>
+            {
+                constexpr static auto idxOoo = findOooIdx<typename Ds<Patterns...>::Type>();
+                using Ps0 = SubTypesT<0, idxOoo, std::tuple<Patterns...>>;
+                using Vs0 = SubTypesT<0, idxOoo, std::tuple<Values...>>;
+                constexpr static auto isBinder =
+                    isOooBinderV<std::tuple_element_t<idxOoo, std::tuple<Patterns...>>>;
+                // <0, ...int32_t> to workaround compile failure for std::tuple<>.
+                using ElemT = std::tuple_element_t<
+                    0, std::tuple<std::remove_reference_t<Values>..., int32_t>>;
+                constexpr static int64_t diff =
+                    static_cast<int64_t>(sizeof...(Values) - sizeof...(Patterns));
+                constexpr static size_t clippedDiff =
+                    static_cast<size_t>(diff > 0 ? diff : 0);
+                using OooResultTuple = typename std::conditional<
+                    isBinder, std::tuple<SubrangeT<std::array<ElemT, clippedDiff>>>,
+                    std::tuple<>>::type;
+                using FirstHalfTuple = typename PairPV<Ps0, Vs0>::type;
+                using Ps1 =
+                    SubTypesT<idxOoo + 1, sizeof...(Patterns), std::tuple<Patterns...>>;
+                constexpr static auto vs1Start =
+                    static_cast<size_t>(static_cast<int64_t>(idxOoo) + 1 + diff);
+                using Vs1 = SubTypesT<vs1Start, sizeof...(Values), std::tuple<Values...>>;
+                using SecondHalfTuple = typename PairPV<Ps1, Vs1>::type;
+
+            public:
+                using type = decltype(std::tuple_cat(std::declval<FirstHalfTuple>(),
+                                                     std::declval<OooResultTuple>(),
+                                                     std::declval<SecondHalfTuple>()));
+            };
+
+            template <typename Tuple>
+            using AppResultForTuple = typename AppResultForTupleHelper<
+                nbOooOrBinder, decltype(drop<0>(std::declval<Tuple>()))>::type;
+
+            template <typename RangeType>
+            using RangeTuple =
+                std::conditional_t<nbOooOrBinder == 1, std::tuple<SubrangeT<RangeType>>,
+                                   std::tuple<>>;
+
+            template <typename RangeType>
+            using RangeElemT =
+                std::conditional_t<isStreamingV<RangeType>, StreamElemT<RangeType>,
+                                   decltype(*std::begin(std::declval<RangeType>()))>;
+
+            template <typename RangeType>
+            using AppResultForRangeType = decltype(std::tuple_cat(
+                std::declval<RangeTuple<RangeType>>(),
+                std::declval<typename PatternTraits<Patterns>::template AppResultTuple<
+                    RangeElemT<RangeType>>>()...));
+
+            template <typename Value, typename = std::void_t<>>
+            class AppResultHelper;
+
+            template <typename Value>
+            class AppResultHelper<Value, std::enable_if_t<isTupleLikeV<Value>>>
+            {
+            public:
+                using type = AppResultForTuple<Value>;
+            };
+
+            template <typename RangeType>
+            class AppResultHelper<RangeType, std::enable_if_t<!isTupleLikeV<RangeType> &&
+                                                              isRangeV<RangeType>>>
+            {
+            public:
+                using type = AppResultForRangeType<RangeType>;
+            };
+
+            template <typename Value>
+            using AppResultTuple = typename AppResultHelper<Value>::type;
+
+            constexpr static auto nbIdV = (PatternTraits<Patterns>::nbIdV + ... + 0);
+
+            template <typename Elem>
+            constexpr static auto hasByteLiteralsV = (isByteLiteralV<Patterns, Elem> || ...);
+
+            // Compares the byte literals before and after ooo against size elements.
+            template <typename Elem>
+            static bool compareLiteralBytes(Elem const *data, std::size_t size,
+                                            Ds<Patterns...> const &dsPat)
+            {
+                constexpr auto nbPat = sizeof...(Patterns);
+                if constexpr (nbOooOrBinder == 0)
+                {
+                    static_cast<void>(size);
+                    return compareLiteralRuns<0, nbPat>(data, dsPat.patterns());
+                }
+                else
+                {
+                    constexpr auto idxOoo = findOooIdx<typename Ds<Patterns...>::Type>();
+                    return compareLiteralRuns<0, idxOoo>(data, dsPat.patterns()) &&
+                           compareLiteralRuns<idxOoo + 1, nbPat>(
+                               data + (size - (nbPat - idxOoo - 1)), dsPat.patterns());
+                }
+            }
+
+            template <typename ValueTuple, typename ContextT>
             constexpr static auto matchPatternImpl(ValueTuple &&valueTuple,
                                                    Ds<Patterns...> const &dsPat,
                                                    int32_t depth, ContextT &context)
                 -> std::enable_if_t<isTupleLikeV<ValueTuple>, bool>
             {
-                if constexpr (nbOooOrBinder == 0)
+                using Elem = ContiguousElemT<ValueTuple>;
+                if constexpr (hasByteLiteralsV<Elem>)
+                {
+                    if (!isConstantEvaluated())
+                    {
+                        return matchTuple<Elem>(std::forward<ValueTuple>(valueTuple), dsPat,
+                                                depth, context);
+                    }
+                }
+                return matchTuple<void>(std::forward<ValueTuple>(valueTuple), dsPat, depth,
+                                        context);
+            }
+
+            // Checked is the element type of arrays whose byte literals are compared in
+            // bulk first, void otherwise.
+            template <typename Checked, typename ValueTuple, typename ContextT>
+            constexpr static bool matchTuple(ValueTuple &&valueTuple,
+                                             Ds<Patterns...> const &dsPat, int32_t depth,
+                                             ContextT &context)
+            {
+                if constexpr (nbOooOrBinder == 0 && !std::is_void_v<Checked>)
+                {
+                    constexpr auto nbPat = sizeof...(Patterns);
+                    return compareLiteralBytes(std::data(valueTuple), nbPat, dsPat) &&
+                           matchPatternMultiple<0, 0, nbPat, Checked>(
+                               std::forward<ValueTuple>(valueTuple), dsPat.patterns(), depth,
+                               context);
+                }
+                else if constexpr (nbOooOrBinder == 0)
                 {
                     return std::apply(
                         [&valueTuple, depth, &context](auto const &...patterns)
@@ -1376,11 +2704,18 @@ namespace matchit
                     constexpr auto isBinder =
                         isOooBinderV<std::tuple_element_t<idxOoo, std::tuple<Patterns...>>>;
                     constexpr auto isArray = isArrayV<ValueTuple>;
-                    auto result = matchPatternMultiple<0, 0, idxOoo>(
-                        std::forward<ValueTuple>(valueTuple), dsPat.patterns(), depth,
-                        context);
                     constexpr auto valLen = std::tuple_size_v<std::decay_t<ValueTuple>>;
                     constexpr auto patLen = sizeof...(Patterns);
+                    if constexpr (!std::is_void_v<Checked>)
+                    {
+                        if (!compareLiteralBytes(std::data(valueTuple), valLen, dsPat))
+                        {
+                            return false;
+                        }
+                    }
+                    auto result = matchPatternMultiple<0, 0, idxOoo, Checked>(
+                        std::forward<ValueTuple>(valueTuple), dsPat.patterns(), depth,
+                        context);
                     if constexpr (isArray)
                     {
                         if constexpr (isBinder)
@@ -1400,7 +2735,8 @@ namespace matchit
                         static_assert(!isBinder);
                     }
                     return result && matchPatternMultiple<valLen - patLen + idxOoo + 1,
-                                                          idxOoo + 1, patLen - idxOoo - 1>(
+                                                          idxOoo + 1, patLen - idxOoo - 1,
+                                                          Checked>(
                                          std::forward<ValueTuple>(valueTuple),
                                          dsPat.patterns(), depth, context);
                 }
@@ -1414,61 +2750,211 @@ namespace matchit
                                     bool>
             {
                 static_assert(nbOooOrBinder == 0 || nbOooOrBinder == 1);
-                constexpr auto nbPat = sizeof...(Patterns);
+                if constexpr (isStreamingV<ValueRange>)
+                {
+                    return matchStream(valueRange, dsPat, depth, context);
+                }
+                else
+                {
+                    using Elem = ContiguousElemT<ValueRange>;
+                    if constexpr (hasByteLiteralsV<Elem>)
+                    {
+                        if (!isConstantEvaluated())
+                        {
+                            return matchSized<Elem>(valueRange, dsPat, depth, context);
+                        }
+                    }
+                    return matchSized<void>(valueRange, dsPat, depth, context);
+                }
+            }
 
+            template <typename Checked, typename ValueRange, typename ContextT>
+            constexpr static bool matchSized(ValueRange &valueRange,
+                                             Ds<Patterns...> const &dsPat, int32_t depth,
+                                             ContextT &context)
+            {
+                constexpr auto nbPat = sizeof...(Patterns);
+                auto const valLen = static_cast<std::size_t>(valueRange.size());
+                auto iter = std::begin(valueRange);
                 if constexpr (nbOooOrBinder == 0)
                 {
                     // size mismatch for dynamic array is not an error;
-                    if (valueRange.size() != nbPat)
+                    if (valLen != nbPat)
                     {
                         return false;
                     }
-                    return matchPatternRange<0, nbPat>(std::begin(valueRange),
-                                                       dsPat.patterns(), depth, context);
+                    if constexpr (!std::is_void_v<Checked>)
+                    {
+                        if (!compareLiteralBytes(std::data(valueRange), valLen, dsPat))
+                        {
+                            return false;
+                        }
+                    }
+                    return matchPatternRange<0, nbPat, Checked>(iter, dsPat.patterns(), depth,
+                                                                context);
                 }
                 else if constexpr (nbOooOrBinder == 1)
                 {
-                    if (valueRange.size() < nbPat - 1)
+                    if (valLen < nbPat - 1)
                     {
                         return false;
                     }
                     constexpr auto idxOoo = findOooIdx<typename Ds<Patterns...>::Type>();
                     constexpr auto isBinder =
                         isOooBinderV<std::tuple_element_t<idxOoo, std::tuple<Patterns...>>>;
-                    auto result = matchPatternRange<0, idxOoo>(
-                        std::begin(valueRange), dsPat.patterns(), depth, context);
-                    auto const valLen = valueRange.size();
                     constexpr auto patLen = sizeof...(Patterns);
-                    auto const beginOoo = std::next(std::begin(valueRange), idxOoo);
+                    constexpr auto nbAfterOoo = patLen - idxOoo - 1;
+                    if constexpr (!std::is_void_v<Checked>)
+                    {
+                        if (!compareLiteralBytes(std::data(valueRange), valLen, dsPat))
+                        {
+                            return false;
+                        }
+                    }
+                    if (!matchPatternRange<0, idxOoo, Checked>(iter, dsPat.patterns(), depth,
+                                                               context))
+                    {
+                        return false;
+                    }
+                    auto const beginOoo = iter;
+                    auto const oooLen = valLen - (patLen - 1);
+                    // one step back from the end is cheaper than walking over ooo.
+                    auto const beginAfterOoo = [&]
+                    {
+                        using IterT = decltype(iter);
+                        using Category = typename std::iterator_traits<IterT>::iterator_category;
+                        if constexpr (std::is_same_v<IterT, decltype(std::end(valueRange))> &&
+                                      std::is_base_of_v<std::bidirectional_iterator_tag,
+                                                        Category>)
+                        {
+                            return std::prev(std::end(valueRange),
+                                             static_cast<std::ptrdiff_t>(nbAfterOoo));
+                        }
+                        else
+                        {
+                            return std::next(beginOoo, static_cast<std::ptrdiff_t>(oooLen));
+                        }
+                    }();
                     if constexpr (isBinder)
                     {
-                        auto const rangeSize = static_cast<long>(valLen - (patLen - 1));
-                        auto const end = std::next(beginOoo, rangeSize);
-                        context.emplace_back(makeSubrange(beginOoo, end));
-                        using type = decltype(makeSubrange(beginOoo, end));
-                        result = result && matchPattern(std::get<type>(context.back()),
-                                                        std::get<idxOoo>(dsPat.patterns()),
-                                                        depth, context);
+                        context.emplace_back(makeSubrange(beginOoo, beginAfterOoo, oooLen));
+                        using type = decltype(makeSubrange(beginOoo, beginAfterOoo));
+                        if (!matchPattern(std::get<type>(context.back()),
+                                          std::get<idxOoo>(dsPat.patterns()), depth,
+                                          context))
+                        {
+                            return false;
+                        }
                     }
-                    auto const beginAfterOoo =
-                        std::next(beginOoo, static_cast<long>(valLen - patLen + 1));
-                    return result && matchPatternRange<idxOoo + 1, patLen - idxOoo - 1>(
-                                         beginAfterOoo, dsPat.patterns(), depth, context);
+                    iter = beginAfterOoo;
+                    return matchPatternRange<idxOoo + 1, nbAfterOoo, Checked>(
+                        iter, dsPat.patterns(), depth, context);
                 }
             }
 
-            constexpr static void processIdImpl(Ds<Patterns...> const &dsPat,
-                                                int32_t depth, IdProcess idProcess)
+            // The elements before ooo are consumed lazily. The elements after it are
+            // found with a lookahead of exactly that many: a second iterator on
+            // multi-pass ranges, a ring buffer of values on input-only ones.
+            // Input-only ranges are consumed, dispatchMatch buffers them when
+            // several arms read them.
+            template <typename ValueRange, typename ContextT>
+            constexpr static bool matchStream(ValueRange &valueRange,
+                                              Ds<Patterns...> const &dsPat, int32_t depth,
+                                              ContextT &context)
             {
-                return std::apply(
-                    [depth, idProcess](auto &&...patterns)
+                constexpr auto nbPat = sizeof...(Patterns);
+                auto iter = std::begin(valueRange);
+                auto const end = std::end(valueRange);
+                using IterT = decltype(iter);
+                if constexpr (nbOooOrBinder == 0)
+                {
+                    return matchPatternStream<0, nbPat>(iter, end, dsPat.patterns(), depth,
+                                                        context) &&
+                           iter == end;
+                }
+                else
+                {
+                    constexpr auto idxOoo = findOooIdx<typename Ds<Patterns...>::Type>();
+                    constexpr auto isBinder =
+                        isOooBinderV<std::tuple_element_t<idxOoo, std::tuple<Patterns...>>>;
+                    constexpr auto nbAfterOoo = nbPat - idxOoo - 1;
+                    static_assert(!isBinder || (isMultiPassV<IterT> &&
+                                                std::is_same_v<IterT, std::decay_t<decltype(end)>>),
+                                  "Binding ooo needs a multi-pass range whose end is an iterator.");
+                    if (!matchPatternStream<0, idxOoo>(iter, end, dsPat.patterns(), depth,
+                                                       context))
                     {
-                        return (processId(patterns, depth, idProcess), ...);
-                    },
-                    dsPat.patterns());
-            }
-        };
-
+                        return false;
+                    }
+                    if constexpr (nbAfterOoo == 0 && !isBinder)
+                    {
+                        // the rest of the stream is never read.
+                        return true;
+                    }
+                    else if constexpr (isMultiPassV<IterT>)
+                    {
+                        auto lead = iter;
+                        for (std::size_t i = 0; i < nbAfterOoo; ++i)
+                        {
+                            if (lead == end)
+                            {
+                                return false;
+                            }
+                            ++lead;
+                        }
+                        auto const beginOoo = iter;
+                        std::size_t oooLen = 0;
+                        for (; lead != end; ++lead, ++iter)
+                        {
+                            ++oooLen;
+                        }
+                        if constexpr (isBinder)
+                        {
+                            context.emplace_back(makeSubrange(beginOoo, iter, oooLen));
+                            using type = decltype(makeSubrange(beginOoo, iter));
+                            if (!matchPattern(std::get<type>(context.back()),
+                                              std::get<idxOoo>(dsPat.patterns()), depth,
+                                              context))
+                            {
+                                return false;
+                            }
+                        }
+                        return matchPatternStream<idxOoo + 1, nbAfterOoo>(
+                            iter, end, dsPat.patterns(), depth, context);
+                    }
+                    else
+                    {
+                        using ElemT = std::decay_t<decltype(*iter)>;
+                        static_assert(std::is_default_constructible_v<ElemT>,
+                                      "Patterns after ooo on an input range buffer elements "
+                                      "that must be default constructible.");
+                        auto ring = std::array<ElemT, nbAfterOoo>{};
+                        std::size_t count = 0;
+                        for (; iter != end; ++iter)
+                        {
+                            ring[count % nbAfterOoo] = *iter;
+                            ++count;
+                        }
+                        return count >= nbAfterOoo &&
+                               matchPatternRing<idxOoo + 1>(
+                                   ring, count, dsPat.patterns(), depth, context,
+                                   std::make_index_sequence<nbAfterOoo>{});
+                    }
+                }
+            }
+
+            constexpr static void processIdImpl(Ds<Patterns...> const &dsPat,
+                                                int32_t depth, IdProcess idProcess)
+            {
+                return std::apply(
+                    [depth, idProcess](auto &&...patterns)
+                    {
+                        return (processId(patterns, depth, idProcess), ...);
+                    },
+                    dsPat.patterns());
+            }
+        };
+
         static_assert(
             std::is_same_v<
                 typename PatternTraits<
@@ -1490,6 +2976,275 @@ namespace matchit
                     AppResultTuple<std::array<int32_t, 3>>,
                 std::tuple<matchit::impl::Subrange<int32_t *, int32_t *>>>);
 
+        enum class Endian
+        {
+            kBIG,
+            kLITTLE
+        };
+
+        // The narrowest unsigned type holding width bits.
+        template <std::size_t width>
+        using UintT = std::conditional_t<
+            width <= 8, uint8_t,
+            std::conditional_t<width <= 16, uint16_t,
+                               std::conditional_t<width <= 32, uint32_t, uint64_t>>>;
+
+        // A field of width bits in a bin pattern, its pattern is matched against the
+        // field read as an unsigned integer.
+        template <std::size_t width, Endian endian, typename Pattern>
+        class BitField
+        {
+            static_assert(width > 0 && width <= 64, "Fields are 1 to 64 bits wide.");
+            static_assert(endian == Endian::kBIG || width % 8 == 0,
+                          "Little endian fields are made of whole bytes.");
+
+        public:
+            constexpr explicit BitField(Pattern const &pattern) : mPattern{pattern} {}
+            constexpr auto const &pattern() const { return mPattern; }
+
+        private:
+            Pattern const mPattern;
+        };
+
+        template <std::size_t width, typename Pattern>
+        constexpr auto be(Pattern const &pattern)
+        {
+            return BitField<width, Endian::kBIG, Pattern>{pattern};
+        }
+
+        template <std::size_t width, typename Pattern>
+        constexpr auto le(Pattern const &pattern)
+        {
+            return BitField<width, Endian::kLITTLE, Pattern>{pattern};
+        }
+
+        // Bitfields are read most significant bit first, as in network headers.
+        template <std::size_t width, typename Pattern>
+        constexpr auto bits(Pattern const &pattern)
+        {
+            return be<width>(pattern);
+        }
+
+        template <std::size_t width, Endian endian, typename Pattern>
+        class PatternTraits<BitField<width, endian, Pattern>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple =
+                typename PatternTraits<Pattern>::template AppResultTuple<Value>;
+
+            constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
+
+            template <typename Value, typename ContextT>
+            constexpr static auto
+            matchPatternImpl(Value &&value, BitField<width, endian, Pattern> const &field,
+                             int32_t depth, ContextT &context)
+            {
+                return matchPattern(std::forward<Value>(value), field.pattern(), depth + 1,
+                                    context);
+            }
+            constexpr static void processIdImpl(BitField<width, endian, Pattern> const &field,
+                                                int32_t depth, IdProcess idProcess)
+            {
+                processId(field.pattern(), depth, idProcess);
+            }
+        };
+
+        template <typename T>
+        constexpr std::size_t fieldWidthV = 0;
+
+        template <std::size_t width, Endian endian, typename Pattern>
+        constexpr std::size_t fieldWidthV<BitField<width, endian, Pattern>> = width;
+
+        // Reads the field at bit offset from bytes, with at most 8 byte loads that
+        // compilers merge into one.
+        template <std::size_t offset, std::size_t width, Endian endian, typename Byte>
+        constexpr UintT<width> loadField(Byte const *bytes)
+        {
+            constexpr auto first = offset / 8;
+            constexpr auto shift = offset % 8;
+            constexpr auto nbBytes = (shift + width + 7) / 8;
+            static_assert(shift + width <= 64,
+                          "A field must fit in the 8 bytes from its first byte.");
+            static_assert(endian == Endian::kBIG || shift == 0,
+                          "Little endian fields start on a byte boundary.");
+            uint64_t word = 0;
+            for (std::size_t i = 0; i < nbBytes; ++i)
+            {
+                auto const byte =
+                    static_cast<uint64_t>(static_cast<unsigned char>(bytes[first + i]));
+                if constexpr (endian == Endian::kBIG)
+                {
+                    word = (word << 8) | byte;
+                }
+                else
+                {
+                    word |= byte << (8 * i);
+                }
+            }
+            if constexpr (endian == Endian::kBIG)
+            {
+                word >>= nbBytes * 8 - shift - width;
+            }
+            constexpr auto mask = width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+            return static_cast<UintT<width>>(word & mask);
+        }
+
+        template <typename Range, typename = std::void_t<>>
+        struct HasData : std::false_type
+        {
+        };
+
+        template <typename Range>
+        struct HasData<Range, std::void_t<decltype(std::data(std::declval<Range &>()))>>
+            : std::true_type
+        {
+        };
+
+        // The first byte of a contiguous range, from data() or from ranges iterated by
+        // pointers such as Subrange.
+        template <typename Range>
+        constexpr auto bytesOf(Range const &range)
+        {
+            if constexpr (HasData<Range const>::value)
+            {
+                return std::data(range);
+            }
+            else
+            {
+                return std::begin(range);
+            }
+        }
+
+        template <typename Range>
+        using ByteT = std::remove_cv_t<std::remove_pointer_t<decltype(bytesOf(
+            std::declval<std::remove_reference_t<Range> const &>()))>>;
+
+        template <typename Range>
+        using BytesT = Subrange<ByteT<Range> const *, ByteT<Range> const *>;
+
+        template <typename... Fields>
+        class Bin
+        {
+        public:
+            constexpr explicit Bin(Fields const &...fields) : mFields{fields...} {}
+            constexpr auto const &fields() const { return mFields; }
+
+        private:
+            std::tuple<Fields...> mFields;
+        };
+
+        // Matches a byte buffer field by field. The last field may be ooo, or ooo bound
+        // to the rest of the buffer as a Subrange over the same bytes.
+        template <typename... Fields>
+        constexpr auto bin(Fields const &...fields)
+        {
+            return Bin<Fields...>{fields...};
+        }
+
+        template <typename... Fields>
+        class PatternTraits<Bin<Fields...>>
+        {
+            constexpr static auto nbFields = sizeof...(Fields);
+            constexpr static auto nbTail = nbOooOrBinderV<Fields...>;
+            constexpr static auto nbBitFields = nbFields - nbTail;
+            static_assert(nbTail == 0 || (nbTail == 1 && isOooOrBinderV<std::tuple_element_t<
+                                                              nbFields - 1, std::tuple<Fields...>>>),
+                          "Only the last field of bin can be ooo.");
+            static_assert(((fieldWidthV<Fields> != 0) + ... + 0) == nbBitFields,
+                          "The fields of bin are be, le, bits or a trailing ooo.");
+
+            constexpr static std::size_t widths[] = {fieldWidthV<Fields>..., 0};
+            constexpr static std::size_t offsetOf(std::size_t idx)
+            {
+                std::size_t offset = 0;
+                for (std::size_t i = 0; i < idx; ++i)
+                {
+                    offset += widths[i];
+                }
+                return offset;
+            }
+            constexpr static auto nbBytes = offsetOf(nbBitFields) / 8;
+            static_assert(offsetOf(nbBitFields) % 8 == 0,
+                          "The fields of bin must add up to whole bytes.");
+            constexpr static auto isBinder = nbTail == 1 && (isOooBinderV<Fields> || ...);
+
+            template <typename Field, typename Bytes>
+            using FieldValueT =
+                std::conditional_t<fieldWidthV<Field> == 0, Bytes, UintT<fieldWidthV<Field>>>;
+
+            template <typename Value>
+            using BinderTuple = std::conditional_t<isBinder, std::tuple<BytesT<Value>>, std::tuple<>>;
+
+        public:
+            template <typename Value>
+            using AppResultTuple = decltype(std::tuple_cat(
+                std::declval<BinderTuple<Value>>(),
+                std::declval<typename PatternTraits<Fields>::template AppResultTuple<
+                    FieldValueT<Fields, BytesT<Value>>>>()...));
+
+            constexpr static auto nbIdV = (PatternTraits<Fields>::nbIdV + ... + 0);
+
+            template <typename Value, typename ContextT>
+            constexpr static bool matchPatternImpl(Value &&value, Bin<Fields...> const &binPat,
+                                                   int32_t depth, ContextT &context)
+            {
+                using Byte = ByteT<Value>;
+                static_assert(sizeof(Byte) == 1 && std::is_pointer_v<decltype(bytesOf(value))>,
+                              "bin matches contiguous ranges of bytes.");
+                Byte const *const bytes = bytesOf(value);
+                auto const size = static_cast<std::size_t>(std::size(value));
+                if (nbTail == 0 ? size != nbBytes : size < nbBytes)
+                {
+                    return false;
+                }
+                if (!matchFields(bytes, binPat, depth, context,
+                                 std::make_index_sequence<nbBitFields>{}))
+                {
+                    return false;
+                }
+                if constexpr (isBinder)
+                {
+                    context.emplace_back(makeSubrange(bytes + nbBytes, bytes + size));
+                    return matchPattern(std::get<BytesT<Value>>(context.back()),
+                                        std::get<nbFields - 1>(binPat.fields()), depth,
+                                        context);
+                }
+                return true;
+            }
+
+            constexpr static void processIdImpl(Bin<Fields...> const &binPat, int32_t depth,
+                                                IdProcess idProcess)
+            {
+                return std::apply(
+                    [depth, idProcess](auto &&...fields)
+                    { return (processId(fields, depth, idProcess), ...); },
+                    binPat.fields());
+            }
+
+        private:
+            template <typename Byte, typename ContextT, std::size_t... I>
+            constexpr static bool matchFields(Byte const *bytes, Bin<Fields...> const &binPat,
+                                              int32_t depth, ContextT &context,
+                                              std::index_sequence<I...>)
+            {
+                static_cast<void>(bytes);
+                return (matchField<offsetOf(I)>(bytes, std::get<I>(binPat.fields()), depth,
+                                                context) &&
+                        ...);
+            }
+
+            template <std::size_t offset, typename Byte, std::size_t width, Endian endian,
+                      typename Pattern, typename ContextT>
+            constexpr static bool matchField(Byte const *bytes,
+                                             BitField<width, endian, Pattern> const &field,
+                                             int32_t depth, ContextT &context)
+            {
+                return matchPattern(loadField<offset, width, endian>(bytes), field, depth + 1,
+                                    context);
+            }
+        };
+
         template <typename Pattern, typename Pred>
         class PostCheck
         {
@@ -1512,6 +3267,8 @@ namespace matchit
             using AppResultTuple =
                 typename PatternTraits<Pattern>::template AppResultTuple<Value>;
 
+            constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
+
             template <typename Value, typename ContextT>
             constexpr static auto
             matchPatternImpl(Value &&value, PostCheck<Pattern, Pred> const &postCheck,
@@ -1553,70 +3310,3119 @@ namespace matchit
         static_assert(PatternTraits<Or<Id<int32_t>, Id<float>>>::nbIdV == 2);
         static_assert(PatternTraits<Or<Wildcard, float>>::nbIdV == 0);
 
+        template <typename T>
+        constexpr auto isIntegralOrEnumV =
+            std::is_integral_v<std::decay_t<T>> || std::is_enum_v<std::decay_t<T>>;
+
+        template <typename Value, typename Pattern, typename = std::void_t<>>
+        struct IsLiteralArm : std::false_type
+        {
+        };
+
+        template <typename Value, typename Pattern>
+        struct IsLiteralArm<Value, Pattern,
+                            std::void_t<decltype(std::declval<Pattern const &>() ==
+                                                 std::declval<Value const &>())>>
+            : std::bool_constant<isIntegralOrEnumV<Pattern> && isIntegralOrEnumV<Value>>
+        {
+        };
+
+        template <typename Value>
+        struct IsLiteralArm<Value, Wildcard> : std::true_type
+        {
+        };
+
+        // All arms are integral / enum literals or wildcards, like cases of a switch.
         template <typename Value, typename... PatternPairs>
-        constexpr auto matchPatterns(Value &&value, PatternPairs const &...patterns)
+        constexpr auto isLiteralDispatchV =
+            isIntegralOrEnumV<Value> &&
+            (IsLiteralArm<std::decay_t<Value>,
+                          typename PatternPairs::PatternT>::value &&
+             ...);
+
+        static_assert(isLiteralDispatchV<int32_t, PatternPair<int32_t, void (*)()>,
+                                         PatternPair<Wildcard, void (*)()>>);
+        static_assert(!isLiteralDispatchV<int32_t, PatternPair<Id<int32_t>, void (*)()>>);
+
+        template <typename Value, typename Pattern>
+        constexpr bool matchLiteral(Value const &value, Pattern const &pattern)
         {
-            using RetType = typename PatternPairsRetType<PatternPairs...>::RetType;
-            using TypeTuple = decltype(std::tuple_cat(
-                std::declval<typename PatternTraits<typename PatternPairs::PatternT>::
-                                 template AppResultTuple<Value>>()...));
+            if constexpr (std::is_same_v<Pattern, Wildcard>)
+            {
+                return true;
+            }
+            else
+            {
+                return pattern == value;
+            }
+        }
 
-            // expression, has return value.
-            if constexpr (!std::is_same_v<RetType, void>)
+        template <typename T>
+        constexpr auto literalKey(T const &t)
+        {
+            if constexpr (std::is_enum_v<T>)
+            {
+                return static_cast<std::underlying_type_t<T>>(t);
+            }
+            else
+            {
+                return t;
+            }
+        }
+
+        template <typename... Patterns>
+        constexpr std::size_t firstWildcardIdx()
+        {
+            constexpr std::array<bool, sizeof...(Patterns) + 1> isWildcard = {
+                std::is_same_v<Patterns, Wildcard>..., true};
+            std::size_t idx = 0;
+            while (!isWildcard[idx])
+            {
+                ++idx;
+            }
+            return idx;
+        }
+
+        static_assert(firstWildcardIdx<int32_t, Wildcard, int32_t>() == 1);
+        static_assert(firstWildcardIdx<int32_t, int32_t>() == 2);
+
+        // The literals before the first wildcard share one type, so they can be
+        // turned into a key table.
+        template <typename... Patterns>
+        constexpr bool isLiteralTable()
+        {
+            using LiteralT = std::tuple_element_t<0, std::tuple<Patterns..., Wildcard>>;
+            constexpr auto nbLiterals = firstWildcardIdx<Patterns...>();
+            constexpr std::array<bool, sizeof...(Patterns) + 1> sameType = {
+                std::is_same_v<Patterns, LiteralT>..., true};
+            auto result = nbLiterals > 0 && !std::is_same_v<LiteralT, bool>;
+            for (std::size_t i = 0; i < nbLiterals; ++i)
+            {
+                result = result && sameType[i];
+            }
+            return result;
+        }
+
+        static_assert(isLiteralTable<int32_t, int32_t, Wildcard, char>());
+        static_assert(!isLiteralTable<int32_t, char, Wildcard>());
+        static_assert(!isLiteralTable<Wildcard, int32_t>());
+
+        // Literals of a match, sorted once along with the arms they belong to. Only
+        // the first arm of equal literals is kept. Consecutive literals are found
+        // by their offset from the lowest one, the others by a binary search.
+        template <typename Key, std::size_t nbLiterals>
+        class LiteralTable
+        {
+        public:
+            constexpr explicit LiteralTable(std::array<Key, nbLiterals> const &keys)
             {
-                constexpr auto const func =
-                    [](auto const &pattern, auto &&value, RetType &result) constexpr->bool
+                // insertion sort, linear for literals written in order.
+                for (std::size_t i = 0; i < nbLiterals; ++i)
                 {
-                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
-                    if (pattern.matchValue(std::forward<Value>(value), context))
+                    auto j = mNbKeys;
+                    while (j > 0 && keys[i] < mKeys[j - 1])
                     {
-                        result = pattern.execute();
-                        processId(pattern, 0, IdProcess::kCANCEL);
-                        return true;
+                        --j;
                     }
-                    return false;
-                };
-                RetType result{};
-                bool const matched = (func(patterns, value, result) || ...);
-                if (!matched)
+                    if (j > 0 && mKeys[j - 1] == keys[i])
+                    {
+                        // an earlier arm has this literal.
+                        continue;
+                    }
+                    for (auto k = mNbKeys; k > j; --k)
+                    {
+                        mKeys[k] = mKeys[k - 1];
+                        mArmIdx[k] = mArmIdx[k - 1];
+                    }
+                    mKeys[j] = keys[i];
+                    mArmIdx[j] = i;
+                    ++mNbKeys;
+                }
+                using UKey = std::make_unsigned_t<Key>;
+                for (std::size_t i = 1; i < mNbKeys; ++i)
                 {
-                    throw std::logic_error{"Error: no patterns got matched!"};
+                    mDense = mDense && static_cast<UKey>(static_cast<UKey>(mKeys[i]) -
+                                                         static_cast<UKey>(mKeys[0])) == i;
                 }
-                static_cast<void>(matched);
-                return result;
             }
-            else
-            // statement, no return value, mismatching all patterns is not an error.
+            constexpr std::size_t find(Key const key) const
             {
-                auto const func = [](auto const &pattern, auto &&value) -> bool
+                using UKey = std::make_unsigned_t<Key>;
+                // dense jump table.
+                if (mDense)
+                {
+                    auto const offset =
+                        static_cast<UKey>(static_cast<UKey>(key) - static_cast<UKey>(mKeys[0]));
+                    return offset < mNbKeys ? mArmIdx[static_cast<std::size_t>(offset)]
+                                            : nbLiterals;
+                }
+                // binary search.
+                std::size_t lo = 0;
+                std::size_t hi = mNbKeys;
+                while (lo < hi)
                 {
-                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
-                    if (pattern.matchValue(std::forward<Value>(value), context))
+                    auto const mid = lo + (hi - lo) / 2;
+                    if (mKeys[mid] < key)
                     {
-                        pattern.execute();
-                        processId(pattern, 0, IdProcess::kCANCEL);
-                        return true;
+                        lo = mid + 1;
                     }
-                    return false;
-                };
-                bool const matched = (func(patterns, value) || ...);
-                static_cast<void>(matched);
+                    else
+                    {
+                        hi = mid;
+                    }
+                }
+                return lo < mNbKeys && mKeys[lo] == key ? mArmIdx[lo] : nbLiterals;
             }
+
+        private:
+            std::array<Key, nbLiterals> mKeys{};
+            std::array<std::size_t, nbLiterals> mArmIdx{};
+            std::size_t mNbKeys = 0;
+            bool mDense = true;
+        };
+
+        // Up to this many arms found in a table are picked by a chain of compares.
+        // More are picked by halving their range, in logarithmic time.
+        constexpr std::size_t kCHAINED_ARMS = 16;
+
+        template <std::size_t idx, typename... PatternPairs>
+        constexpr auto const &armAt(std::tuple<PatternPairs...> const &arms)
+        {
+            return get<idx>(arms);
         }
 
-    } // namespace impl
+        template <typename Arms, std::size_t... I>
+        constexpr void countFailed(Arms const &arms, std::index_sequence<I...>)
+        {
+            (pairOf(armAt<I>(arms)).count(false), ...);
+        }
 
-    // export symbols
-    using impl::_;
-    using impl::and_;
-    using impl::app;
-    using impl::ds;
-    using impl::Id;
-    using impl::meet;
-    using impl::not_;
-    using impl::ooo;
-    using impl::or_;
+        // The arm idx found in a table, the arms before it counted as failed
+        // attempts.
+        template <std::size_t idx, typename Exec, typename Arms>
+        constexpr bool callArm(Exec const &exec, Arms const &arms)
+        {
+#ifdef MATCHIT_STATS
+            countFailed(arms, std::make_index_sequence<idx>{});
+#endif
+            pairOf(armAt<idx>(arms)).count(true);
+            exec(pairOf(armAt<idx>(arms)));
+            return true;
+        }
+
+        // The arm idx among those in [lo, hi), none when idx is hi and hi is past
+        // the last arm.
+        template <std::size_t lo, std::size_t hi, typename Exec, typename Arms>
+        constexpr bool dispatchIdxRange(std::size_t idx, Exec const &exec, Arms const &arms)
+        {
+            if constexpr (hi - lo == 1)
+            {
+                return idx == lo && callArm<lo>(exec, arms);
+            }
+            else
+            {
+                constexpr auto mid = lo + (hi - lo) / 2;
+                if (idx < mid)
+                {
+                    return dispatchIdxRange<lo, mid>(idx, exec, arms);
+                }
+                return dispatchIdxRange<mid, hi>(idx, exec, arms);
+            }
+        }
+
+        template <typename Exec, typename Arms, std::size_t... I>
+        constexpr bool dispatchIdx(std::size_t idx, Exec const &exec, Arms const &arms,
+                                   std::index_sequence<I...>)
+        {
+            if constexpr (sizeof...(I) > kCHAINED_ARMS)
+            {
+                return dispatchIdxRange<0, sizeof...(I)>(idx, exec, arms);
+            }
+            else
+            {
+                // compile-time case labels, lowered to a jump table. The arms before
+                // the one found are counted as failed attempts.
+                return ((pairOf(armAt<I>(arms)).count(idx == I),
+                         expect<std::decay_t<decltype(pairOf(armAt<I>(arms)))>::kHINT>(idx == I) &&
+                             (exec(pairOf(armAt<I>(arms))), true)) ||
+                        ...);
+            }
+        }
+
+        // Tables of the arms that do not depend on the matched value.
+        class NoTable
+        {
+        };
+
+        constexpr NoTable makeTable(NoTable) { return {}; }
+
+        // The keys of the first nbKeys arms. Going through a tuple of hundreds of
+        // arms costs far more to compile than one fold over them.
+        template <typename Key, std::size_t nbKeys, typename KeyOf, typename... PatternPairs,
+                  std::size_t... I>
+        constexpr auto firstKeysImpl(KeyOf const &keyOf, std::index_sequence<I...>,
+                                     PatternPairs const &...patterns)
+        {
+            std::array<Key, nbKeys> keys{};
+            auto const add = [&keys, &keyOf](auto const idx, auto const &arm)
+            {
+                if constexpr (decltype(idx)::value < nbKeys)
+                {
+                    keys[idx] = keyOf(arm.pattern());
+                }
+            };
+            (add(std::integral_constant<std::size_t, I>{}, patterns), ...);
+            return keys;
+        }
+
+        template <typename Key, std::size_t nbKeys, typename KeyOf, typename... PatternPairs>
+        constexpr auto firstKeys(KeyOf const &keyOf, PatternPairs const &...patterns)
+        {
+            return firstKeysImpl<Key, nbKeys>(
+                keyOf, std::make_index_sequence<sizeof...(PatternPairs)>{}, patterns...);
+        }
+
+        template <typename Value, typename... PatternPairs>
+        constexpr auto literalKeys(PatternPairs const &...patterns)
+        {
+            using ValueT = std::decay_t<Value>;
+            constexpr auto nbLiterals =
+                firstWildcardIdx<typename PatternPairs::PatternT...>();
+            using LiteralT = std::tuple_element_t<
+                0, std::tuple<typename PatternPairs::PatternT..., Wildcard>>;
+            if constexpr (isLiteralTable<typename PatternPairs::PatternT...>() &&
+                          !std::is_same_v<ValueT, bool>)
+            {
+                using Key = std::common_type_t<decltype(literalKey(std::declval<ValueT>())),
+                                               decltype(literalKey(std::declval<LiteralT>()))>;
+                return firstKeys<Key, nbLiterals>(
+                    [](auto const &literal) { return static_cast<Key>(literalKey(literal)); },
+                    patterns...);
+            }
+            else
+            {
+                return NoTable{};
+            }
+        }
+
+        template <typename Key, std::size_t nbLiterals>
+        constexpr auto makeTable(std::array<Key, nbLiterals> const &keys)
+        {
+            return LiteralTable<Key, nbLiterals>{keys};
+        }
+
+        template <typename Key, std::size_t nbLiterals, typename Value>
+        constexpr auto findIdx(LiteralTable<Key, nbLiterals> const &table, Value const &value)
+        {
+            return table.find(static_cast<Key>(literalKey(value)));
+        }
+
+        // Keys without a table are compared one by one, in arm order.
+        template <typename Key, typename Value>
+        constexpr bool keyMatches(Key const &key, Value const &value)
+        {
+            return key == static_cast<Key>(literalKey(value));
+        }
+
+        // with a dense jump or a binary search when they are sorted.
+        template <typename Value, typename Exec, typename Table, typename... PatternPairs>
+        constexpr bool dispatchLiterals(Value const &value, Exec const &exec,
+                                        Table const &table, PatternPairs const &...patterns)
+        {
+            if constexpr (!std::is_same_v<Table, NoTable>)
+            {
+                constexpr auto nbArms = std::min(
+                    firstWildcardIdx<typename PatternPairs::PatternT...>() + 1,
+                    sizeof...(PatternPairs));
+                return dispatchIdx(findIdx(table, value), exec,
+                                   std::forward_as_tuple(patterns...),
+                                   std::make_index_sequence<nbArms>{});
+            }
+            else
+            {
+                auto const matchArmLiteral = [&value](auto const &arm)
+                {
+                    auto const matched = matchLiteral(value, arm.pattern());
+                    arm.count(matched);
+                    return matched;
+                };
+                return ((matchArmLiteral(patterns) && (exec(patterns), true)) || ...);
+            }
+        }
+
+        // Integral promotion, other types are kept as they are.
+        template <typename T>
+        using PromotedT = std::conditional_t<
+            std::is_arithmetic_v<T>,
+            decltype(+std::declval<std::conditional_t<std::is_arithmetic_v<T>, T, int32_t>>()),
+            T>;
+
+        // Comparing in the common type gives the same answers as comparing as written.
+        template <typename Value, typename T>
+        constexpr auto isSameOrderV =
+            std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+            ((std::is_integral_v<PromotedT<Value>> && std::is_integral_v<PromotedT<T>> &&
+              std::is_signed_v<PromotedT<Value>> == std::is_signed_v<PromotedT<T>>) ||
+             std::is_floating_point_v<Value>);
+
+        template <typename Value, typename Pattern>
+        class IntervalArm
+        {
+        public:
+            constexpr static auto isInterval = false;
+            constexpr static auto value = isSameOrderV<Value, Pattern>;
+            using KeyT = PromotedT<Pattern>;
+        };
+
+        template <typename Value, typename First, typename Second>
+        class IntervalArm<Value, Meet<Interval<First, Second>>>
+        {
+        public:
+            constexpr static auto isInterval = true;
+            constexpr static auto value = isSameOrderV<Value, typename First::ValueT> &&
+                                          isSameOrderV<Value, typename Second::ValueT>;
+            using KeyT = std::common_type_t<PromotedT<typename First::ValueT>,
+                                            PromotedT<typename Second::ValueT>>;
+        };
+
+        template <typename Value, typename T, typename Cmp, bool wildcardFirst>
+        class IntervalArm<Value, Meet<Bound<T, Cmp, wildcardFirst>>>
+        {
+        public:
+            constexpr static auto isInterval = true;
+            constexpr static auto value =
+                isSameOrderV<Value, typename Bound<T, Cmp, wildcardFirst>::ValueT>;
+            using KeyT = PromotedT<typename Bound<T, Cmp, wildcardFirst>::ValueT>;
+        };
+
+        template <typename Value>
+        class IntervalArm<Value, Wildcard>
+        {
+        public:
+            constexpr static auto isInterval = false;
+            constexpr static auto value = true;
+            using KeyT = PromotedT<Value>;
+        };
+
+        template <typename Value, typename... Patterns>
+        constexpr bool isIntervalDispatch()
+        {
+            constexpr auto nbArms = firstWildcardIdx<Patterns...>();
+            constexpr std::array<bool, sizeof...(Patterns) + 1> isInterval = {
+                IntervalArm<Value, Patterns>::isInterval..., false};
+            constexpr std::array<bool, sizeof...(Patterns) + 1> isValid = {
+                IntervalArm<Value, Patterns>::value..., true};
+            auto hasInterval = false;
+            auto valid = true;
+            for (std::size_t i = 0; i < nbArms; ++i)
+            {
+                hasInterval = hasInterval || isInterval[i];
+                valid = valid && isValid[i];
+            }
+            return hasInterval && valid;
+        }
+
+        // All arms before the first wildcard are intervals, rays or literals of
+        // arithmetic types, with at least one interval or ray.
+        template <typename Value, typename... PatternPairs>
+        constexpr bool isIntervalDispatchV = []
+        {
+            using ValueT = std::decay_t<Value>;
+            if constexpr (std::is_arithmetic_v<ValueT> && !std::is_same_v<ValueT, bool>)
+            {
+                return isIntervalDispatch<ValueT, typename PatternPairs::PatternT...>();
+            }
+            else
+            {
+                return false;
+            }
+        }();
+
+        static_assert(isIntervalDispatchV<
+                      int32_t, PatternPair<decltype(0 <= _ && _ < 10), void (*)()>,
+                      PatternPair<int32_t, void (*)()>, PatternPair<Wildcard, void (*)()>>);
+        static_assert(!isIntervalDispatchV<
+                      int32_t, PatternPair<decltype(0U <= _ && _ < 10U), void (*)()>>);
+        static_assert(!isIntervalDispatchV<
+                      int32_t, PatternPair<decltype(_ < 10 && _ < 20), void (*)()>>);
+
+        template <typename Pattern>
+        class IsBound : public std::false_type
+        {
+        };
+
+        template <typename T, typename Cmp, bool wildcardFirst>
+        class IsBound<Meet<Bound<T, Cmp, wildcardFirst>>> : public std::true_type
+        {
+        };
+
+        template <typename Key>
+        struct KeyInterval
+        {
+            Key lo;
+            Key hi;
+            bool loInclusive;
+            bool hiInclusive;
+        };
+
+        template <typename Key>
+        constexpr bool operator==(KeyInterval<Key> const &lhs, KeyInterval<Key> const &rhs)
+        {
+            return lhs.lo == rhs.lo && lhs.hi == rhs.hi && lhs.loInclusive == rhs.loInclusive &&
+                   lhs.hiInclusive == rhs.hiInclusive;
+        }
+
+        template <typename Key, typename Pattern>
+        constexpr auto keyInterval(Pattern const &pattern)
+        {
+            if constexpr (IsBound<Pattern>::value)
+            {
+                // rays reach the ends of the key type.
+                using Limits = std::numeric_limits<Key>;
+                constexpr auto lowest =
+                    Limits::has_infinity ? -Limits::infinity() : Limits::lowest();
+                constexpr auto highest =
+                    Limits::has_infinity ? Limits::infinity() : Limits::max();
+                auto const key = static_cast<Key>(pattern.value());
+                if constexpr (Pattern::isLower)
+                {
+                    return KeyInterval<Key>{key, highest, Pattern::isInclusive, true};
+                }
+                else
+                {
+                    return KeyInterval<Key>{lowest, key, true, Pattern::isInclusive};
+                }
+            }
+            else if constexpr (IntervalArm<Key, Pattern>::isInterval)
+            {
+                auto const &lower = pattern.lower();
+                auto const &upper = pattern.upper();
+                return KeyInterval<Key>{static_cast<Key>(lower.value()),
+                                        static_cast<Key>(upper.value()),
+                                        std::decay_t<decltype(lower)>::isInclusive,
+                                        std::decay_t<decltype(upper)>::isInclusive};
+            }
+            else
+            {
+                auto const key = static_cast<Key>(pattern);
+                return KeyInterval<Key>{key, key, true, true};
+            }
+        }
+
+        constexpr std::size_t kLINEAR_INTERVALS = 16;
+
+        template <typename Key>
+        constexpr bool startsBefore(KeyInterval<Key> const &lhs, KeyInterval<Key> const &rhs)
+        {
+            return lhs.lo < rhs.lo || (lhs.lo == rhs.lo && lhs.loInclusive && !rhs.loInclusive);
+        }
+
+        // Intervals of a match, sorted by their lower bounds once, along with the
+        // arms they belong to. Whether they are non-empty and disjoint is checked
+        // once too.
+        template <typename Key, std::size_t nbIntervals>
+        class IntervalTable
+        {
+        public:
+            constexpr explicit IntervalTable(
+                std::array<KeyInterval<Key>, nbIntervals> const &intervals)
+                : mIntervals{intervals}
+            {
+                for (std::size_t i = 0; i < nbIntervals; ++i)
+                {
+                    mArmIdx[i] = i;
+                }
+                // insertion sort, linear for intervals written in order.
+                for (std::size_t i = 1; i < nbIntervals; ++i)
+                {
+                    for (auto j = i; j > 0 && startsBefore(mIntervals[j], mIntervals[j - 1]); --j)
+                    {
+                        auto const interval = mIntervals[j];
+                        mIntervals[j] = mIntervals[j - 1];
+                        mIntervals[j - 1] = interval;
+                        auto const armIdx = mArmIdx[j];
+                        mArmIdx[j] = mArmIdx[j - 1];
+                        mArmIdx[j - 1] = armIdx;
+                    }
+                }
+                for (std::size_t i = 0; i < nbIntervals; ++i)
+                {
+                    auto const &cur = mIntervals[i];
+                    mDisjoint &= cur.lo < cur.hi ||
+                                 (cur.lo == cur.hi && cur.loInclusive && cur.hiInclusive);
+                    if (i > 0)
+                    {
+                        auto const &prev = mIntervals[i - 1];
+                        mDisjoint &= prev.hi < cur.lo ||
+                                     (prev.hi == cur.lo && !(prev.hiInclusive && cur.loInclusive));
+                    }
+                }
+                // closed integral intervals, compared without looking at the flags.
+                if constexpr (std::is_integral_v<Key>)
+                {
+                    using Limits = std::numeric_limits<Key>;
+                    constexpr auto empty =
+                        KeyInterval<Key>{Limits::max(), Limits::lowest(), true, true};
+                    for (auto &cur : mIntervals)
+                    {
+                        if (!cur.loInclusive)
+                        {
+                            cur = cur.lo == Limits::max() ? empty
+                                                          : KeyInterval<Key>{
+                                                                static_cast<Key>(cur.lo + 1),
+                                                                cur.hi, true, cur.hiInclusive};
+                        }
+                        if (!cur.hiInclusive)
+                        {
+                            cur = cur.hi == Limits::lowest()
+                                      ? empty
+                                      : KeyInterval<Key>{cur.lo, static_cast<Key>(cur.hi - 1),
+                                                         true, true};
+                        }
+                    }
+                    for (std::size_t i = 0; i < nbIntervals; ++i)
+                    {
+                        mLows[i] = mIntervals[i].lo;
+                    }
+                }
+            }
+            constexpr std::size_t find(Key const key) const
+            {
+                constexpr auto closed = std::is_integral_v<Key>;
+                auto const aboveLo = [key](KeyInterval<Key> const &i)
+                { return (closed || i.loInclusive) ? i.lo <= key : i.lo < key; };
+                auto const belowHi = [key](KeyInterval<Key> const &i)
+                { return (closed || i.hiInclusive) ? key <= i.hi : key < i.hi; };
+                if (mDisjoint)
+                {
+                    std::size_t base = 0;
+                    if constexpr (closed && nbIntervals <= kLINEAR_INTERVALS)
+                    {
+                        // few closed intervals, count the lower bounds below the key.
+                        auto const count = countLows(key, std::make_index_sequence<nbIntervals>{});
+                        base = count > 0 ? count - 1 : 0;
+                    }
+                    else
+                    {
+                        // branch-free binary search for the last interval starting at
+                        // or before the key.
+                        for (auto size = nbIntervals; size > 1; size -= size / 2)
+                        {
+                            auto const mid = base + size / 2;
+                            base = aboveLo(mIntervals[mid]) ? mid : base;
+                        }
+                    }
+                    // arithmetic instead of a branch, a key outside every interval is
+                    // as likely as not.
+                    auto const &found = mIntervals[base];
+                    auto const outside = static_cast<std::size_t>(!aboveLo(found)) |
+                                         static_cast<std::size_t>(!belowHi(found));
+                    auto const armIdx = mArmIdx[base];
+                    return armIdx + outside * (nbIntervals - armIdx);
+                }
+                // overlapping or empty intervals, the first arm wins.
+                auto armIdx = nbIntervals;
+                for (std::size_t i = 0; i < nbIntervals; ++i)
+                {
+                    if (aboveLo(mIntervals[i]) && belowHi(mIntervals[i]))
+                    {
+                        armIdx = std::min(armIdx, mArmIdx[i]);
+                    }
+                }
+                return armIdx;
+            }
+
+        private:
+            template <std::size_t... I>
+            constexpr std::size_t countLows(Key const key, std::index_sequence<I...>) const
+            {
+                return (static_cast<std::size_t>(mLows[I] <= key) + ...);
+            }
+
+            std::array<KeyInterval<Key>, nbIntervals> mIntervals;
+            std::array<std::size_t, nbIntervals> mArmIdx{};
+            std::array<Key, nbIntervals> mLows{};
+            bool mDisjoint = true;
+        };
+
+        template <typename Value, typename... PatternPairs>
+        constexpr auto intervalKeys(PatternPairs const &...patterns)
+        {
+            using ValueT = std::decay_t<Value>;
+            constexpr auto nbIntervals =
+                firstWildcardIdx<typename PatternPairs::PatternT...>();
+            using Key = std::common_type_t<
+                PromotedT<ValueT>,
+                typename IntervalArm<ValueT, typename PatternPairs::PatternT>::KeyT...>;
+            return firstKeys<KeyInterval<Key>, nbIntervals>(
+                [](auto const &interval) { return keyInterval<Key>(interval); }, patterns...);
+        }
+
+        template <typename Key, std::size_t nbIntervals>
+        constexpr auto makeTable(std::array<KeyInterval<Key>, nbIntervals> const &keys)
+        {
+            return IntervalTable<Key, nbIntervals>{keys};
+        }
+
+        template <typename Key, std::size_t nbIntervals, typename Value>
+        constexpr auto findIdx(IntervalTable<Key, nbIntervals> const &table,
+                               Value const &value)
+        {
+            return table.find(static_cast<Key>(value));
+        }
+
+        template <typename Key, typename Value>
+        constexpr bool keyMatches(KeyInterval<Key> const &key, Value const &value)
+        {
+            auto const k = static_cast<Key>(value);
+            return (key.loInclusive ? key.lo <= k : key.lo < k) &&
+                   (key.hiInclusive ? k <= key.hi : k < key.hi);
+        }
+
+        // Boundaries of the interval arms form a table, searched in logarithmic time
+        // when the intervals are disjoint and ascending.
+        template <typename Value, typename Exec, typename Table, typename... PatternPairs>
+        constexpr bool dispatchIntervals(Value const &value, Exec const &exec,
+                                         Table const &table, PatternPairs const &...patterns)
+        {
+            constexpr auto nbArms =
+                std::min(firstWildcardIdx<typename PatternPairs::PatternT...>() + 1,
+                         sizeof...(PatternPairs));
+            return dispatchIdx(findIdx(table, value), exec,
+                               std::forward_as_tuple(patterns...),
+                               std::make_index_sequence<nbArms>{});
+        }
+
+        template <typename Pattern>
+        class IsStringLiteral : public std::false_type
+        {
+        };
+
+        template <std::size_t N>
+        class IsStringLiteral<StringLiteral<N>> : public std::true_type
+        {
+        };
+
+        // All arms are string literals or wildcards.
+        template <typename Value, typename... PatternPairs>
+        constexpr auto isStringDispatchV =
+            isStringLikeV<Value> &&
+            ((IsStringLiteral<typename PatternPairs::PatternT>::value ||
+              std::is_same_v<typename PatternPairs::PatternT, Wildcard>)&&...) &&
+            IsStringLiteral<std::tuple_element_t<
+                0, std::tuple<typename PatternPairs::PatternT...>>>::value;
+
+        // FNV-1a over the characters.
+        constexpr std::uint64_t stringHash(std::string_view const str)
+        {
+            std::uint64_t hash = 14695981039346656037ULL;
+            for (auto const c : str)
+            {
+                hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+            }
+            return hash;
+        }
+
+        // At least twice as many slots as literals, a power of two.
+        constexpr std::size_t stringSlots(std::size_t const nbLiterals)
+        {
+            std::size_t slots = 1;
+            while (slots < 2 * nbLiterals)
+            {
+                slots *= 2;
+            }
+            return slots;
+        }
+
+        // The literals of a match, hashed into open-addressed slots once, the
+        // first arm kept for equal literals. A lookup hashes the subject, probes
+        // the hashes of the slots and compares the one literal with its hash.
+        template <std::size_t nbLiterals>
+        class StringTable
+        {
+        public:
+            constexpr explicit StringTable(
+                std::array<std::string_view, nbLiterals> const &literals)
+            {
+                for (auto &idx : mIdx)
+                {
+                    idx = nbLiterals;
+                }
+                for (std::size_t i = 0; i < nbLiterals; ++i)
+                {
+                    auto const hash = stringHash(literals[i]);
+                    auto slot = static_cast<std::size_t>(hash) & kMASK;
+                    while (mIdx[slot] != nbLiterals && mLiterals[slot] != literals[i])
+                    {
+                        slot = (slot + 1) & kMASK;
+                    }
+                    if (mIdx[slot] == nbLiterals)
+                    {
+                        mHashes[slot] = hash;
+                        mLiterals[slot] = literals[i];
+                        mIdx[slot] = i;
+                    }
+                }
+            }
+            constexpr std::size_t find(std::string_view const str) const
+            {
+                auto const hash = stringHash(str);
+                for (auto slot = static_cast<std::size_t>(hash) & kMASK; mIdx[slot] != nbLiterals;
+                     slot = (slot + 1) & kMASK)
+                {
+                    if (mHashes[slot] == hash && mLiterals[slot] == str)
+                    {
+                        return mIdx[slot];
+                    }
+                }
+                return nbLiterals;
+            }
+
+        private:
+            constexpr static auto kSLOTS = stringSlots(nbLiterals);
+            constexpr static auto kMASK = kSLOTS - 1;
+            std::array<std::uint64_t, kSLOTS> mHashes{};
+            std::array<std::string_view, kSLOTS> mLiterals{};
+            std::array<std::size_t, kSLOTS> mIdx{};
+        };
+
+        // The literals viewed where they are, in the arms.
+        template <typename Value, typename... PatternPairs>
+        constexpr auto stringKeys(PatternPairs const &...patterns)
+        {
+            constexpr auto nbLiterals =
+                firstWildcardIdx<typename PatternPairs::PatternT...>();
+            return firstKeys<std::string_view, nbLiterals>(
+                [](auto const &literal)
+                { return std::string_view{literal.data(), literal.size()}; },
+                patterns...);
+        }
+
+        template <std::size_t nbLiterals>
+        constexpr auto makeTable(std::array<std::string_view, nbLiterals> const &keys)
+        {
+            return StringTable<nbLiterals>{keys};
+        }
+
+        template <std::size_t nbLiterals, typename Value>
+        constexpr auto findIdx(StringTable<nbLiterals> const &table, Value const &value)
+        {
+            return table.find(std::string_view{value});
+        }
+
+        // Literals of other sizes are ruled out first, then those ending with
+        // another character, so that the characters of at most one literal of
+        // each size are compared in practice. The sizes of literals the optimizer
+        // knows turn the arms into a switch over the size of the subject.
+        template <typename Value>
+        constexpr bool keyMatches(std::string_view const key, Value const &value)
+        {
+            auto const str = std::string_view{value};
+            auto const size = key.size();
+            return size == str.size() &&
+                   (size == 0 || (key[size - 1] == str[size - 1] &&
+                                  std::char_traits<char>::compare(key.data(), str.data(),
+                                                                  size - 1) == 0));
+        }
+
+        template <typename Value, typename Exec, typename Table, typename... PatternPairs>
+        constexpr bool dispatchStrings(Value const &value, Exec const &exec,
+                                       Table const &table, PatternPairs const &...patterns)
+        {
+            constexpr auto nbArms =
+                std::min(firstWildcardIdx<typename PatternPairs::PatternT...>() + 1,
+                         sizeof...(PatternPairs));
+            return dispatchIdx(findIdx(table, value), exec,
+                               std::forward_as_tuple(patterns...),
+                               std::make_index_sequence<nbArms>{});
+        }
+
+        template <typename Value, typename Exec, typename... PatternPairs>
+        class BeforeHandler;
+
+        template <typename Exec>
+        constexpr bool ownsSubjectV = false;
+
+        template <typename Value, typename Exec, typename... PatternPairs>
+        constexpr bool ownsSubjectV<BeforeHandler<Value, Exec, PatternPairs...>> =
+            !std::is_lvalue_reference_v<Value>;
+
+        // The context of an arm, one that knows the subject when it is a temporary.
+        template <typename ContextT, typename Pattern, typename Exec>
+        constexpr auto armContext(Exec const &exec)
+        {
+            if constexpr (ownsSubjectV<Exec>)
+            {
+                return OwningContext<ContextT, typename Exec::SubjectT,
+                                     PatternTraits<Pattern>::nbIdV>{exec.subject()};
+            }
+            else
+            {
+                static_cast<void>(exec);
+                return ContextT{};
+            }
+        }
+
+        template <typename Value, typename PatternPair, typename Exec, typename ContextT>
+        constexpr bool matchArm(Value &&value, PatternPair const &pattern, Exec const &exec,
+                                ContextT &context)
+        {
+            if (expect<PatternPair::kHINT>(
+                    pattern.matchValue(std::forward<Value>(value), context)))
+            {
+                exec(pattern);
+                return true;
+            }
+            return false;
+        }
+
+        template <typename Value, typename PatternPair, typename Exec>
+        constexpr bool dispatchArm(Value &&value, PatternPair const &pattern,
+                                   Exec const &exec)
+        {
+            auto context =
+                armContext<ArmContextT<Value, PatternPair>, typename PatternPair::PatternT>(exec);
+            return matchArm(std::forward<Value>(value), pattern, exec, context);
+        }
+
+        template <typename Value, typename Pattern, typename = std::void_t<>>
+        struct IsColumnLiteral : std::false_type
+        {
+        };
+
+        template <typename Value, typename Pattern>
+        struct IsColumnLiteral<Value, Pattern,
+                               std::void_t<decltype(std::declval<Pattern const &>() ==
+                                                    std::declval<Value const &>())>>
+            : std::bool_constant<std::is_arithmetic_v<Pattern> || std::is_enum_v<Pattern> ||
+                                 std::is_pointer_v<Pattern>>
+        {
+        };
+
+        template <typename Value, std::size_t col>
+        using ColumnT = std::decay_t<decltype(get<col>(std::declval<Value>()))>;
+
+        template <typename Value, typename Pattern>
+        class DsArm
+        {
+        public:
+            constexpr static auto value = std::is_same_v<Pattern, Wildcard>;
+            constexpr static auto nbLiterals = 0;
+        };
+
+        template <typename Value, typename... Patterns>
+        class DsArm<Value, Ds<Patterns...>>
+        {
+            template <std::size_t... I>
+            constexpr static std::size_t countLiterals(std::index_sequence<I...>)
+            {
+                return ((IsColumnLiteral<ColumnT<Value, I>,
+                                         std::tuple_element_t<I, typename Ds<Patterns...>::Type>>::
+                             value
+                             ? 1U
+                             : 0U) +
+                        ... + 0U);
+            }
+
+        public:
+            constexpr static auto value =
+                nbOooOrBinderV<Patterns...> == 0 &&
+                sizeof...(Patterns) == std::tuple_size_v<std::decay_t<Value>>;
+            constexpr static auto nbLiterals =
+                countLiterals(std::make_index_sequence<value ? sizeof...(Patterns) : 0>{});
+        };
+
+        template <typename Pattern>
+        class IsDs : public std::false_type
+        {
+        };
+
+        template <typename... Patterns>
+        class IsDs<Ds<Patterns...>> : public std::true_type
+        {
+        };
+
+        template <typename Value, typename... PatternPairs>
+        constexpr bool isDsDispatch()
+        {
+            // Only look at the subject when there are ds arms, tuple_size may not be
+            // specialized for it yet.
+            if constexpr ((IsDs<typename PatternPairs::PatternT>::value || ...))
+            {
+                if constexpr (isTupleLikeV<Value>)
+                {
+                    using ValueT = std::decay_t<Value>;
+                    return (DsArm<ValueT, typename PatternPairs::PatternT>::value && ...) &&
+                           ((DsArm<ValueT, typename PatternPairs::PatternT>::nbLiterals > 0
+                                 ? 1
+                                 : 0) +
+                            ... + 0) >= 2;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        // All arms destructure the subject tuple without ooo, and at least two of
+        // them test literal columns.
+        template <typename Value, typename... PatternPairs>
+        constexpr auto isDsDispatchV = isDsDispatch<Value, PatternPairs...>();
+
+        // Arms of a ds match, one bit each.
+        template <std::size_t nbArms>
+        class ArmSet
+        {
+        public:
+            constexpr static ArmSet all()
+            {
+                ArmSet arms;
+                for (std::size_t i = 0; i < nbArms; ++i)
+                {
+                    arms.add(i);
+                }
+                return arms;
+            }
+            constexpr void add(std::size_t const idx)
+            {
+                mWords[idx / 64] |= std::uint64_t{1} << (idx % 64);
+            }
+            constexpr bool has(std::size_t const idx) const
+            {
+                return (mWords[idx / 64] >> (idx % 64) & 1U) != 0;
+            }
+            constexpr bool empty() const
+            {
+                for (auto const word : mWords)
+                {
+                    if (word != 0)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            constexpr ArmSet operator|(ArmSet const &other) const
+            {
+                auto result = *this;
+                for (std::size_t i = 0; i < mWords.size(); ++i)
+                {
+                    result.mWords[i] |= other.mWords[i];
+                }
+                return result;
+            }
+            constexpr ArmSet &operator&=(ArmSet const &other)
+            {
+                for (std::size_t i = 0; i < mWords.size(); ++i)
+                {
+                    mWords[i] &= other.mWords[i];
+                }
+                return *this;
+            }
+
+        private:
+            std::array<std::uint64_t, (nbArms + 63) / 64> mWords{};
+        };
+
+        // Literal cells a ds table looks up, integral or enum literals. The others
+        // are compared arm by arm.
+        template <typename Cell>
+        using CellKeyT = std::conditional_t<(std::is_integral_v<Cell> && !std::is_same_v<Cell, bool>) ||
+                                                std::is_enum_v<Cell>,
+                                            Cell, void>;
+
+        class MixedKeys
+        {
+        };
+
+        // The literals of a column join into one key type while they keep comparing
+        // as written: one enum, or integers of one signedness.
+        template <typename Lhs, typename Rhs>
+        constexpr auto joinKeys()
+        {
+            if constexpr (std::is_void_v<Lhs>)
+            {
+                return static_cast<Rhs *>(nullptr);
+            }
+            else if constexpr (std::is_void_v<Rhs>)
+            {
+                return static_cast<Lhs *>(nullptr);
+            }
+            else if constexpr (std::is_enum_v<Lhs> && std::is_same_v<Lhs, Rhs>)
+            {
+                return static_cast<Lhs *>(nullptr);
+            }
+            else if constexpr (std::is_integral_v<Lhs> && std::is_integral_v<Rhs> &&
+                               std::is_signed_v<Lhs> == std::is_signed_v<Rhs>)
+            {
+                return static_cast<std::common_type_t<PromotedT<Lhs>, PromotedT<Rhs>> *>(nullptr);
+            }
+            else
+            {
+                return static_cast<MixedKeys *>(nullptr);
+            }
+        }
+
+        // The key of the cell of an arm in column col, void for wildcards.
+        template <std::size_t col, typename Pattern>
+        class CellKey
+        {
+        public:
+            using type = void;
+        };
+
+        template <std::size_t col, typename... Patterns>
+        class CellKey<col, Ds<Patterns...>>
+        {
+        public:
+            using type = CellKeyT<std::tuple_element_t<col, typename Ds<Patterns...>::Type>>;
+        };
+
+        template <std::size_t col, typename... Patterns>
+        class ColumnKey
+        {
+        public:
+            using type = void;
+        };
+
+        template <std::size_t col, typename Pattern, typename... Patterns>
+        class ColumnKey<col, Pattern, Patterns...>
+        {
+            using JoinedT = std::remove_pointer_t<decltype(joinKeys<
+                typename CellKey<col, Pattern>::type, typename ColumnKey<col, Patterns...>::type>())>;
+
+        public:
+            using type = std::conditional_t<std::is_same_v<JoinedT, MixedKeys>, void, JoinedT>;
+        };
+
+        static_assert(std::is_same_v<typename ColumnKey<0, Ds<char, int32_t>, Wildcard,
+                                                        Ds<int64_t, Wildcard>>::type,
+                                     int64_t>);
+        static_assert(std::is_void_v<typename ColumnKey<0, Ds<int32_t>, Ds<uint32_t>>::type>);
+
+        // Whether a column of the subject is looked up with the key of its literals,
+        // comparing as the literals would.
+        template <typename Key, typename Column>
+        constexpr bool isTableColumn()
+        {
+            if constexpr (std::is_void_v<Key>)
+            {
+                return false;
+            }
+            else if constexpr (std::is_enum_v<Key>)
+            {
+                return std::is_same_v<Key, Column>;
+            }
+            else
+            {
+                return std::is_integral_v<Column> && !std::is_same_v<Column, bool> &&
+                       std::is_signed_v<Column> == std::is_signed_v<Key>;
+            }
+        }
+
+        // The literals of one column, sorted, each with the arms testing it, and the
+        // arms that take any value of the column.
+        template <typename Key, std::size_t nbArms>
+        class ColumnTable
+        {
+        public:
+            constexpr void addLiteral(Key const key, std::size_t const armIdx)
+            {
+                auto j = mNbKeys;
+                while (j > 0 && key < mKeys[j - 1])
+                {
+                    --j;
+                }
+                if (j > 0 && mKeys[j - 1] == key)
+                {
+                    mArms[j - 1].add(armIdx);
+                    return;
+                }
+                for (auto k = mNbKeys; k > j; --k)
+                {
+                    mKeys[k] = mKeys[k - 1];
+                    mArms[k] = mArms[k - 1];
+                }
+                mKeys[j] = key;
+                mArms[j] = ArmSet<nbArms>{};
+                mArms[j].add(armIdx);
+                ++mNbKeys;
+            }
+            constexpr void addAny(std::size_t const armIdx) { mAny.add(armIdx); }
+            // binary search.
+            template <typename Column>
+            constexpr ArmSet<nbArms> find(Column const &column) const
+            {
+                using CommonT = std::common_type_t<Key, PromotedT<Column>>;
+                auto const key = static_cast<CommonT>(column);
+                std::size_t lo = 0;
+                std::size_t hi = mNbKeys;
+                while (lo < hi)
+                {
+                    auto const mid = lo + (hi - lo) / 2;
+                    if (static_cast<CommonT>(mKeys[mid]) < key)
+                    {
+                        lo = mid + 1;
+                    }
+                    else
+                    {
+                        hi = mid;
+                    }
+                }
+                if (lo < mNbKeys && static_cast<CommonT>(mKeys[lo]) == key)
+                {
+                    return mArms[lo] | mAny;
+                }
+                return mAny;
+            }
+
+        private:
+            std::array<Key, nbArms> mKeys{};
+            std::array<ArmSet<nbArms>, nbArms> mArms{};
+            std::size_t mNbKeys = 0;
+            ArmSet<nbArms> mAny{};
+        };
+
+        template <std::size_t nbArms>
+        class ColumnTable<void, nbArms>
+        {
+        };
+
+        // The decision tree of a ds match, built from its arms alone: a column
+        // looked up in its table leaves the arms with its literal and the arms
+        // taking any value, and the next column narrows those down.
+        template <std::size_t nbArms, typename... Keys>
+        class DsTable
+        {
+        public:
+            template <typename... PatternPairs>
+            constexpr explicit DsTable(PatternPairs const &...patterns)
+            {
+                std::size_t armIdx = 0;
+                (addArm(patterns.pattern(), armIdx++), ...);
+            }
+            template <typename Value>
+            constexpr ArmSet<nbArms> candidates(Value const &value) const
+            {
+                auto arms = ArmSet<nbArms>::all();
+                narrow(arms, value, std::index_sequence_for<Keys...>{});
+                return arms;
+            }
+            template <std::size_t col, typename Value>
+            constexpr static bool isTableColumnV =
+                isTableColumn<std::tuple_element_t<col, std::tuple<Keys...>>,
+                              ColumnT<Value const &, col>>();
+
+        private:
+            template <typename Pattern>
+            constexpr void addArm(Pattern const &pattern, std::size_t const armIdx)
+            {
+                addCells(pattern, armIdx, std::index_sequence_for<Keys...>{});
+            }
+            template <typename Pattern, std::size_t... C>
+            constexpr void addCells(Pattern const &pattern, std::size_t const armIdx,
+                                    std::index_sequence<C...>)
+            {
+                (addCell<C>(pattern, armIdx), ...);
+            }
+            template <std::size_t col, typename Pattern>
+            constexpr void addCell(Pattern const &pattern, std::size_t const armIdx)
+            {
+                using Key = std::tuple_element_t<col, std::tuple<Keys...>>;
+                if constexpr (!std::is_void_v<Key>)
+                {
+                    if constexpr (std::is_void_v<typename CellKey<col, Pattern>::type>)
+                    {
+                        get<col>(mColumns).addAny(armIdx);
+                    }
+                    else
+                    {
+                        get<col>(mColumns).addLiteral(
+                            static_cast<Key>(get<col>(pattern.patterns())), armIdx);
+                    }
+                }
+            }
+            template <typename Value, std::size_t... C>
+            constexpr void narrow(ArmSet<nbArms> &arms, Value const &value,
+                                  std::index_sequence<C...>) const
+            {
+                // stops at the first column that leaves no arm.
+                static_cast<void>((narrow<C>(arms, value) && ...));
+            }
+            template <std::size_t col, typename Value>
+            constexpr bool narrow(ArmSet<nbArms> &arms, Value const &value) const
+            {
+                if constexpr (isTableColumnV<col, Value>)
+                {
+                    arms &= get<col>(mColumns).find(get<col>(value));
+                    return !arms.empty();
+                }
+                else
+                {
+                    return true;
+                }
+            }
+
+            std::tuple<ColumnTable<Keys, nbArms>...> mColumns{};
+        };
+
+        template <typename Pattern>
+        class DsShape
+        {
+        public:
+            constexpr static auto valid = std::is_same_v<Pattern, Wildcard>;
+            constexpr static std::size_t size = 0;
+        };
+
+        template <typename... Patterns>
+        class DsShape<Ds<Patterns...>>
+        {
+        public:
+            constexpr static auto valid = nbOooOrBinderV<Patterns...> == 0;
+            constexpr static std::size_t size = sizeof...(Patterns);
+        };
+
+        // Arms that all destructure a tuple of the same size without ooo, or are
+        // wildcards. Their table can be built before a subject is seen.
+        template <typename... Patterns>
+        constexpr bool isDsSite()
+        {
+            constexpr auto size = std::max({std::size_t{0}, DsShape<Patterns>::size...});
+            return size > 0 && (DsShape<Patterns>::valid && ...) &&
+                   ((DsShape<Patterns>::size == size || std::is_same_v<Patterns, Wildcard>)&&...);
+        }
+
+        template <typename... PatternPairs, std::size_t... C>
+        constexpr auto dsTable(std::index_sequence<C...>, PatternPairs const &...patterns)
+        {
+            return DsTable<sizeof...(PatternPairs),
+                           typename ColumnKey<C, typename PatternPairs::PatternT...>::type...>{
+                patterns...};
+        }
+
+        template <typename... PatternPairs>
+        constexpr auto dsTable(PatternPairs const &...patterns)
+        {
+            constexpr auto nbColumns =
+                std::max({std::size_t{0}, DsShape<typename PatternPairs::PatternT>::size...});
+            return dsTable(std::make_index_sequence<nbColumns>{}, patterns...);
+        }
+
+        // Literal cells the table did not decide, compared with the subject.
+        template <std::size_t col, typename Table, typename Value, typename PatternPair>
+        constexpr bool cellMatches(Value const &value, PatternPair const &pattern)
+        {
+            using PatternT = typename PatternPair::PatternT;
+            if constexpr (std::is_same_v<PatternT, Wildcard>)
+            {
+                return true;
+            }
+            else
+            {
+                using CellT = std::tuple_element_t<col, typename PatternT::Type>;
+                if constexpr (IsColumnLiteral<ColumnT<Value const &, col>, CellT>::value &&
+                              !(Table::template isTableColumnV<col, Value> &&
+                                !std::is_void_v<typename CellKey<col, PatternT>::type>))
+                {
+                    return get<col>(pattern.pattern().patterns()) == get<col>(value);
+                }
+                else
+                {
+                    return true;
+                }
+            }
+        }
+
+        template <typename Table, typename Value, typename PatternPair, std::size_t... C>
+        constexpr bool literalCellsMatch(Value const &value, PatternPair const &pattern,
+                                         std::index_sequence<C...>)
+        {
+            return (cellMatches<C, Table>(value, pattern) && ...);
+        }
+
+        template <typename Value, typename Exec, typename Table, std::size_t... I,
+                  typename... PatternPairs>
+        constexpr bool dispatchDsArms(Value &&value, Exec const &exec, Table const &table,
+                                      std::index_sequence<I...>,
+                                      PatternPairs const &...patterns)
+        {
+            using Columns = std::make_index_sequence<std::tuple_size_v<std::decay_t<Value>>>;
+            auto const arms = table.candidates(value);
+            auto const isCandidate = [&value, &arms](std::size_t const idx, auto const &arm)
+            {
+                auto const candidate =
+                    arms.has(idx) && literalCellsMatch<Table>(value, arm, Columns{});
+                if (!candidate)
+                {
+                    arm.count(false);
+                }
+                return candidate;
+            };
+            return ((isCandidate(I, patterns) &&
+                     dispatchArm(std::forward<Value>(value), patterns, exec)) ||
+                    ...);
+        }
+
+        // The table leaves the arms whose integral and enum literals match the
+        // subject, in arm order. Their other literal cells are compared next, and
+        // only then do they run their full match.
+        template <typename Value, typename Exec, typename Table, typename... PatternPairs>
+        constexpr bool dispatchDs(Value &&value, Exec const &exec, Table const &table,
+                                  PatternPairs const &...patterns)
+        {
+            return dispatchDsArms(std::forward<Value>(value), exec, table,
+                                  std::index_sequence_for<PatternPairs...>{}, patterns...);
+        }
+
+        // A literal cell that can stand for its column once it matched: later
+        // literals of the same type are compared with it instead of the column.
+        // Conversions to the column type keep equal literals equal and unequal
+        // ones unequal.
+        template <typename Column, typename Cell>
+        constexpr auto isMemoCellV = std::is_same_v<Column, Cell> ||
+                                     (std::is_integral_v<Column> && std::is_integral_v<Cell>);
+
+        // The literal type of column col in an arm, void when it has none.
+        template <typename Value, std::size_t col, typename Pattern>
+        class CellLiteral
+        {
+        public:
+            using type = void;
+        };
+
+        template <typename Value, std::size_t col, typename... Patterns>
+        class CellLiteral<Value, col, Ds<Patterns...>>
+        {
+            using CellT = std::tuple_element_t<col, typename Ds<Patterns...>::Type>;
+            using ColumnType = ColumnT<Value const &, col>;
+
+        public:
+            using type = std::conditional_t<IsColumnLiteral<ColumnType, CellT>::value &&
+                                                isMemoCellV<ColumnType, CellT>,
+                                            CellT, void>;
+        };
+
+        // The literal type of the first arm that tests column col.
+        template <typename Value, std::size_t col, typename... Patterns>
+        class FirstCellLiteral
+        {
+        public:
+            using type = void;
+        };
+
+        template <typename Value, std::size_t col, typename Pattern, typename... Patterns>
+        class FirstCellLiteral<Value, col, Pattern, Patterns...>
+        {
+            using CellT = typename CellLiteral<Value, col, Pattern>::type;
+
+        public:
+            using type = typename std::conditional_t<
+                std::is_void_v<CellT>, FirstCellLiteral<Value, col, Patterns...>,
+                CellLiteral<Value, col, Pattern>>::type;
+        };
+
+        // The literal a column matched, once an arm found it.
+        template <typename T>
+        class ColumnMemo
+        {
+        public:
+            bool mKnown = false;
+            T mLiteral{};
+        };
+
+        template <>
+        class ColumnMemo<void>
+        {
+        };
+
+        template <typename Value, typename... PatternPairs, std::size_t... C>
+        constexpr auto columnMemos(std::index_sequence<C...>)
+        {
+            return std::tuple<ColumnMemo<typename FirstCellLiteral<
+                Value, C, typename PatternPairs::PatternT...>::type>...>{};
+        }
+
+        template <std::size_t col, typename Value, typename PatternPair, typename Memo>
+        constexpr bool memoCellMatches(Value const &value, PatternPair const &pattern, Memo &memo)
+        {
+            using PatternT = typename PatternPair::PatternT;
+            if constexpr (std::is_same_v<PatternT, Wildcard>)
+            {
+                return true;
+            }
+            else
+            {
+                using CellT = std::tuple_element_t<col, typename PatternT::Type>;
+                if constexpr (IsColumnLiteral<ColumnT<Value const &, col>, CellT>::value)
+                {
+                    auto const &cell = get<col>(pattern.pattern().patterns());
+                    if constexpr (std::is_same_v<Memo, ColumnMemo<CellT>>)
+                    {
+                        if (memo.mKnown)
+                        {
+                            return cell == memo.mLiteral;
+                        }
+                        auto const matched = cell == get<col>(value);
+                        memo = {matched, cell};
+                        return matched;
+                    }
+                    else
+                    {
+                        return cell == get<col>(value);
+                    }
+                }
+                else
+                {
+                    return true;
+                }
+            }
+        }
+
+        template <typename Value, typename PatternPair, typename Memos, std::size_t... C>
+        constexpr bool memoCellsMatch(Value const &value, PatternPair const &pattern,
+                                      Memos &memos, std::index_sequence<C...>)
+        {
+            return (memoCellMatches<C>(value, pattern, get<C>(memos)) && ...);
+        }
+
+        // Without a table, as for a one-shot match, arms are tried in order, each
+        // one tests its literal columns before its full match. A column that
+        // matched a literal decides the literals of the same type in later arms
+        // without reading the subject again. What is a literal column of which
+        // arm is known at compile time.
+        template <typename Value, typename Exec, typename... PatternPairs>
+        constexpr bool dispatchDsInOrder(Value &&value, Exec const &exec,
+                                         PatternPairs const &...patterns)
+        {
+            using Columns = std::make_index_sequence<std::tuple_size_v<std::decay_t<Value>>>;
+            auto memos = columnMemos<Value, PatternPairs...>(Columns{});
+            auto const isCandidate = [&value, &memos](auto const &arm)
+            {
+                auto const candidate = memoCellsMatch(value, arm, memos, Columns{});
+                if (!candidate)
+                {
+                    arm.count(false);
+                }
+                return candidate;
+            };
+            return ((isCandidate(patterns) &&
+                     dispatchArm(std::forward<Value>(value), patterns, exec)) ||
+                    ...);
+        }
+
+        // Customization point for closed class hierarchies with a kind tag, provide
+        //   constexpr static auto kind(Base const &base), reading the tag once, and
+        //   template <typename Derived> constexpr static auto kindOf, the tag of Derived.
+        // as<Derived> then compares tags and uses static_cast instead of dynamic_cast.
+        template <typename Base>
+        class KindTraits
+        {
+        };
+
+        template <typename Base, typename = std::void_t<>>
+        class HasKind : public std::false_type
+        {
+        };
+
+        template <typename Base>
+        class HasKind<Base, std::void_t<decltype(KindTraits<Base>::kind(
+                                std::declval<Base const &>()))>> : public std::true_type
+        {
+        };
+
+        template <typename Base>
+        constexpr auto hasKindV = HasKind<std::decay_t<Base>>::value;
+
+        template <typename Derived, typename Base>
+        constexpr auto kindOfV = KindTraits<std::decay_t<Base>>::template kindOf<Derived>;
+
+        static_assert(!hasKindV<int32_t>);
+
+        // Whether Derived can be reached from Base with static_cast, not through a
+        // virtual or an ambiguous base.
+        template <typename Base, typename Derived, typename = std::void_t<>>
+        class IsStaticDowncast : public std::false_type
+        {
+        };
+
+        template <typename Base, typename Derived>
+        class IsStaticDowncast<Base, Derived,
+                               std::void_t<decltype(static_cast<Derived const *>(
+                                   std::declval<Base const *>()))>> : public std::true_type
+        {
+        };
+
+        template <typename Base, typename Derived>
+        constexpr auto isStaticDowncastV = IsStaticDowncast<Base, Derived>::value;
+
+        template <typename T>
+        class AsPointer;
+
+        // The T of an as<T>(...) arm, void for other patterns.
+        template <typename Pattern>
+        class AsArm
+        {
+        public:
+            using type = void;
+        };
+
+        template <typename T, typename Pattern>
+        class AsArm<App<AsPointer<T> const &, Pattern>>
+        {
+        public:
+            using type = T;
+        };
+
+        template <typename T, typename Pattern>
+        class AsArm<App<AsPointer<T>, Pattern>>
+        {
+        public:
+            using type = T;
+        };
+
+        template <typename Pattern>
+        using AsArmT = typename AsArm<Pattern>::type;
+
+        template <typename... Ts>
+        auto variantBase(std::variant<Ts...> const &) -> std::variant<Ts...>;
+
+        // std::variant, or the std::variant a type derives from.
+        template <typename Value, typename = std::void_t<>>
+        class VariantBase
+        {
+        public:
+            using type = void;
+        };
+
+        template <typename Value>
+        class VariantBase<Value,
+                          std::void_t<decltype(variantBase(std::declval<Value const &>()))>>
+        {
+        public:
+            using type = decltype(variantBase(std::declval<Value const &>()));
+        };
+
+        template <typename Value>
+        using VariantBaseT = typename VariantBase<std::decay_t<Value>>::type;
+
+        constexpr auto kNoAlternative = std::variant_npos;
+
+        template <typename T, typename Variant>
+        class AlternativeIdx
+        {
+        public:
+            constexpr static auto value = kNoAlternative;
+        };
+
+        // Only unique alternatives can be reached by get_if.
+        template <typename T, typename... Ts>
+        class AlternativeIdx<T, std::variant<Ts...>>
+        {
+            constexpr static std::array<bool, sizeof...(Ts)> sameType = {
+                std::is_same_v<T, Ts>...};
+
+            constexpr static std::size_t find()
+            {
+                auto idx = kNoAlternative;
+                for (std::size_t i = 0; i < sizeof...(Ts); ++i)
+                {
+                    if (sameType[i])
+                    {
+                        if (idx != kNoAlternative)
+                        {
+                            return kNoAlternative;
+                        }
+                        idx = i;
+                    }
+                }
+                return idx;
+            }
+
+        public:
+            constexpr static auto value = find();
+        };
+
+        template <typename T, typename Variant>
+        constexpr auto alternativeIdxV = AlternativeIdx<T, Variant>::value;
+
+        static_assert(alternativeIdxV<bool, std::variant<int32_t, bool>> == 1);
+        static_assert(alternativeIdxV<char, std::variant<int32_t, bool>> == kNoAlternative);
+        static_assert(alternativeIdxV<bool, std::variant<bool, bool>> == kNoAlternative);
+
+        template <typename Variant, typename Pattern>
+        constexpr auto isVariantArmV =
+            std::is_same_v<Pattern, Wildcard> ||
+            alternativeIdxV<AsArmT<Pattern>, Variant> != kNoAlternative;
+
+        // All arms are as<T>(...) over distinct alternatives or wildcards.
+        template <typename Value, typename... PatternPairs>
+        constexpr auto isVariantDispatchV =
+            !std::is_same_v<VariantBaseT<Value>, void> &&
+            (isVariantArmV<VariantBaseT<Value>, typename PatternPairs::PatternT> && ...) &&
+            !(std::is_same_v<typename PatternPairs::PatternT, Wildcard> && ...);
+
+        template <typename Base, typename Pattern>
+        constexpr auto isKindArmV =
+            std::is_same_v<Pattern, Wildcard> ||
+            (std::is_base_of_v<Base, AsArmT<Pattern>> &&
+             !std::is_same_v<Base, AsArmT<Pattern>>);
+
+        // All arms are as<Derived>(...) over a base with KindTraits, or wildcards.
+        template <typename Value, typename... PatternPairs>
+        constexpr auto isKindDispatchV =
+            hasKindV<Value> &&
+            (isKindArmV<std::decay_t<Value>, typename PatternPairs::PatternT> && ...) &&
+            !(std::is_same_v<typename PatternPairs::PatternT, Wildcard> && ...);
+
+        // Match the pattern of an app(unary, pattern) against an already projected
+        // value, as PatternTraits<App>::matchPatternImpl + processId would do.
+        template <typename Projected, typename Unary, typename Pattern, typename ContextT>
+        constexpr bool matchProjected(Projected &&projected,
+                                      App<Unary, Pattern> const &appPat, int32_t depth,
+                                      ContextT &context)
+        {
+            auto const result = matchPattern(std::forward<Projected>(projected),
+                                             appPat.pattern(), depth + 1, context);
+            processId(appPat, depth, result ? IdProcess::kCONFIRM : IdProcess::kCANCEL);
+            return result;
+        }
+
+        template <typename Value, std::size_t alt, typename Variant, typename PatternPair,
+                  typename Exec>
+        constexpr bool dispatchAlternativeArm(Variant const &variant,
+                                              PatternPair const &pattern,
+                                              Exec const &exec)
+        {
+            using PatternT = typename PatternPair::PatternT;
+            if constexpr (std::is_same_v<PatternT, Wildcard>)
+            {
+                pattern.count(true);
+                exec(pattern);
+                return true;
+            }
+            else if constexpr (alternativeIdxV<AsArmT<PatternT>, Variant> != alt)
+            {
+                pattern.count(false);
+                return false;
+            }
+            else
+            {
+                auto context = armContext<ArmContextT<Value, PatternPair>, PatternT>(exec);
+                auto const matched = matchProjected(std::get_if<alt>(&variant),
+                                                    pattern.pattern(), 0, context);
+                pattern.count(matched);
+                if (expect<PatternPair::kHINT>(matched))
+                {
+                    exec(pattern);
+                    return true;
+                }
+                return false;
+            }
+        }
+
+        template <typename Value, typename Variant, typename Exec, typename... PatternPairs,
+                  std::size_t... I>
+        constexpr bool dispatchAlternatives(Variant const &variant, Exec const &exec,
+                                            std::index_sequence<I...>,
+                                            PatternPairs const &...patterns)
+        {
+            auto const idx = variant.index();
+            // compile-time case labels, lowered to a jump table.
+            auto const alternative = [&](auto alt)
+            {
+                return (dispatchAlternativeArm<Value, decltype(alt)::value>(
+                            variant, patterns, exec) ||
+                        ...);
+            };
+            static_cast<void>(alternative);
+            return ((idx == I && alternative(std::integral_constant<std::size_t, I>{})) ||
+                    ...) ||
+                   (idx == kNoAlternative &&
+                    alternative(std::integral_constant<std::size_t, kNoAlternative>{}));
+        }
+
+        // Read index() once and only try the arms of the active alternative.
+        template <typename Value, typename Exec, typename... PatternPairs>
+        constexpr bool dispatchVariant(Value const &value, Exec const &exec,
+                                       PatternPairs const &...patterns)
+        {
+            using Variant = VariantBaseT<Value>;
+            return dispatchAlternatives<Value const &>(
+                static_cast<Variant const &>(value), exec,
+                std::make_index_sequence<std::variant_size_v<Variant>>{}, patterns...);
+        }
+
+        // The case of the switch on the tag no as<Derived> arm has.
+        class NoKind
+        {
+        };
+
+        template <typename Case, typename Kind>
+        constexpr bool isKindCase(Kind const &kind)
+        {
+            if constexpr (std::is_same_v<Case, NoKind>)
+            {
+                return false;
+            }
+            else
+            {
+                return Case::value == kind;
+            }
+        }
+
+        template <typename Case, typename Value, typename PatternPair, typename Exec>
+        constexpr bool dispatchKindArm(Value const &value, PatternPair const &pattern,
+                                       Exec const &exec)
+        {
+            using PatternT = typename PatternPair::PatternT;
+            if constexpr (std::is_same_v<PatternT, Wildcard>)
+            {
+                pattern.count(true);
+                exec(pattern);
+                return true;
+            }
+            else if constexpr (!isKindCase<Case>(kindOfV<AsArmT<PatternT>, Value>))
+            {
+                pattern.count(false);
+                return false;
+            }
+            else
+            {
+                using Derived = AsArmT<PatternT>;
+                auto context = armContext<ArmContextT<Value const &, PatternPair>, PatternT>(exec);
+                auto const matched = matchProjected(
+                    static_cast<Derived const *>(std::addressof(value)), pattern.pattern(), 0,
+                    context);
+                pattern.count(matched);
+                if (expect<PatternPair::kHINT>(matched))
+                {
+                    exec(pattern);
+                    return true;
+                }
+                return false;
+            }
+        }
+
+        template <typename Value>
+        using KindT = std::decay_t<decltype(KindTraits<std::decay_t<Value>>::kind(
+            std::declval<std::decay_t<Value> const &>()))>;
+
+        template <typename Value, typename Pattern>
+        constexpr auto armKind()
+        {
+            if constexpr (std::is_same_v<Pattern, Wildcard>)
+            {
+                return KindT<Value>{};
+            }
+            else
+            {
+                static_assert(isStaticDowncastV<std::decay_t<Value>, AsArmT<Pattern>>,
+                              "KindTraits needs as<Derived> arms that static_cast can reach, "
+                              "Derived must not derive from the base virtually or ambiguously.");
+                return static_cast<KindT<Value>>(kindOfV<AsArmT<Pattern>, Value>);
+            }
+        }
+
+        template <typename Kind, std::size_t nbArms>
+        class KindCases
+        {
+        public:
+            std::array<Kind, nbArms> mKinds{};
+            std::size_t mSize = 0;
+        };
+
+        // The distinct tags of the arms before the first wildcard, in arm order.
+        template <typename Value, typename... PatternPairs>
+        constexpr auto kindCases()
+        {
+            constexpr auto nbArms = firstWildcardIdx<typename PatternPairs::PatternT...>();
+            auto const kinds = std::array<KindT<Value>, sizeof...(PatternPairs)>{
+                armKind<Value, typename PatternPairs::PatternT>()...};
+            auto cases = KindCases<KindT<Value>, nbArms>{};
+            for (std::size_t i = 0; i < nbArms; ++i)
+            {
+                auto isNew = true;
+                for (std::size_t j = 0; j < cases.mSize; ++j)
+                {
+                    isNew = isNew && !(cases.mKinds[j] == kinds[i]);
+                }
+                if (isNew)
+                {
+                    cases.mKinds[cases.mSize++] = kinds[i];
+                }
+            }
+            return cases;
+        }
+
+        template <typename Value, typename... PatternPairs>
+        constexpr auto kindCasesV = kindCases<Value, PatternPairs...>();
+
+        // One case of the switch on the tag, then the next. Within a case the arms
+        // of other tags are skipped at compile time. The tag is taken by value and
+        // the cases inlined, so that the optimizer sees a plain if-else chain.
+        template <std::size_t idx, typename Value, typename Exec, typename... PatternPairs>
+        MATCHIT_INLINE constexpr bool dispatchKindCase(KindT<Value> const kind,
+                                                       Value const &value, Exec const &exec,
+                                                       PatternPairs const &...patterns)
+        {
+            constexpr auto const &cases = kindCasesV<Value, PatternPairs...>;
+            if constexpr (idx == cases.mSize)
+            {
+                return (dispatchKindArm<NoKind>(value, patterns, exec) || ...);
+            }
+            else
+            {
+                using Case = std::integral_constant<KindT<Value>, cases.mKinds[idx]>;
+                if (kind == Case::value)
+                {
+                    return (dispatchKindArm<Case>(value, patterns, exec) || ...);
+                }
+                return dispatchKindCase<idx + 1>(kind, value, exec, patterns...);
+            }
+        }
+
+        // Read the tag once and switch on it to the as<Derived> arms of that tag.
+        // The cases are compile-time constants in an if-else chain, lowered to a
+        // jump table like a switch.
+        template <typename Value, typename Exec, typename... PatternPairs>
+        constexpr bool dispatchKinds(Value const &value, Exec const &exec,
+                                     PatternPairs const &...patterns)
+        {
+            static_assert(std::is_integral_v<KindT<Value>> || std::is_enum_v<KindT<Value>>,
+                          "KindTraits needs an integral or enum tag to switch on.");
+            return dispatchKindCase<0>(KindTraits<std::decay_t<Value>>::kind(value), value,
+                                       exec, patterns...);
+        }
+
+        // Keys of the arms the table of a match is built from, NoTable when the
+        // arms need none.
+        template <typename Value, typename... PatternPairs>
+        constexpr auto armKeys(PatternPairs const &...patterns)
+        {
+            if constexpr (isLiteralDispatchV<Value, PatternPairs...>)
+            {
+                return literalKeys<Value>(patterns...);
+            }
+            else if constexpr (isIntervalDispatchV<Value, PatternPairs...>)
+            {
+                return intervalKeys<Value>(patterns...);
+            }
+            else if constexpr (isStringDispatchV<Value, PatternPairs...>)
+            {
+                return stringKeys<Value>(patterns...);
+            }
+            else
+            {
+                return NoTable{};
+            }
+        }
+
+        template <typename Value, typename... PatternPairs>
+        constexpr auto dispatchTable(PatternPairs const &...patterns)
+        {
+            if constexpr (isDsDispatchV<Value, PatternPairs...>)
+            {
+                return dsTable(patterns...);
+            }
+            else
+            {
+                return makeTable(armKeys<Value>(patterns...));
+            }
+        }
+
+        // The value type a match site builds its table for: the type of its
+        // literals, the common type of the bounds of its intervals, or
+        // std::string_view for string literals. void for the other arms, and for
+        // bounds that refer to an lvalue, which may change between calls.
+        template <typename Pattern>
+        class SiteKey
+        {
+        public:
+            using type = std::conditional_t<std::is_arithmetic_v<Pattern> || std::is_enum_v<Pattern>,
+                                            Pattern, void>;
+        };
+
+        template <typename T, typename Cmp, bool wildcardFirst>
+        class SiteKey<Meet<Bound<T, Cmp, wildcardFirst>>>
+        {
+        public:
+            using ValueT = typename Bound<T, Cmp, wildcardFirst>::ValueT;
+            using type = std::conditional_t<std::is_same_v<T, ValueT>, ValueT, void>;
+        };
+
+        template <std::size_t N>
+        class SiteKey<StringLiteral<N>>
+        {
+        public:
+            using type = std::string_view;
+        };
+
+        // void unless all keys have a common type.
+        template <typename Keys, typename = void>
+        class CommonSiteKey
+        {
+        public:
+            using type = void;
+        };
+
+        template <typename... Keys>
+        class CommonSiteKey<std::tuple<Keys...>, std::void_t<std::common_type_t<Keys...>>>
+        {
+        public:
+            using type = std::common_type_t<Keys...>;
+        };
+
+        template <typename First, typename Second>
+        class SiteKey<Meet<Interval<First, Second>>>
+        {
+        public:
+            using type = typename CommonSiteKey<std::tuple<typename SiteKey<Meet<First>>::type,
+                                                           typename SiteKey<Meet<Second>>::type>>::type;
+        };
+
+        template <typename Patterns, typename Idx>
+        class SiteValue;
+
+        template <typename... Patterns, std::size_t... I>
+        class SiteValue<std::tuple<Patterns...>, std::index_sequence<I...>>
+        {
+        public:
+            using type = typename CommonSiteKey<std::tuple<typename SiteKey<
+                std::tuple_element_t<I, std::tuple<Patterns...>>>::type...>>::type;
+        };
+
+        // The arms before the first wildcard decide the table.
+        template <typename... Patterns>
+        using SiteValueT = typename SiteValue<
+            std::tuple<Patterns...>,
+            std::make_index_sequence<firstWildcardIdx<Patterns...>()>>::type;
+
+        static_assert(std::is_same_v<SiteValueT<int32_t, int32_t, Wildcard, char>, int32_t>);
+        static_assert(std::is_same_v<SiteValueT<StringLiteral<4>, Wildcard>, std::string_view>);
+        static_assert(std::is_void_v<SiteValueT<Wildcard>>);
+
+        // The table of the arms of a matcher, built once with them.
+        template <typename... PatternPairs>
+        constexpr auto siteTable(PatternPairs const &...patterns)
+        {
+            using Value = SiteValueT<typename PatternPairs::PatternT...>;
+            if constexpr (isDsSite<typename PatternPairs::PatternT...>())
+            {
+                return dsTable(patterns...);
+            }
+            else if constexpr (std::is_void_v<Value>)
+            {
+                return NoTable{};
+            }
+            else
+            {
+                return dispatchTable<Value>(patterns...);
+            }
+        }
+
+        // The table of the site when it was built for keys of the same type, from
+        // the same arms. Otherwise one is built from the arms now, except for the
+        // decision tree of ds arms, which costs more than trying them in order.
+        template <typename Value, typename Site, typename... PatternPairs>
+        constexpr decltype(auto) tableAt(Site const &site, PatternPairs const &...patterns)
+        {
+            if constexpr (std::is_same_v<decltype(dispatchTable<Value>(patterns...)), Site>)
+            {
+                return (site);
+            }
+            else if constexpr (isDsDispatchV<Value, PatternPairs...>)
+            {
+                return NoTable{};
+            }
+            else
+            {
+                return dispatchTable<Value>(patterns...);
+            }
+        }
+
+        template <typename Value, typename Exec, typename Table, typename... PatternPairs>
+        constexpr bool dispatchPatterns(Value &&value, Exec const &exec, Table const &table,
+                                        PatternPairs const &...patterns)
+        {
+            if constexpr (isLiteralDispatchV<Value, PatternPairs...>)
+            {
+                return dispatchLiterals(value, exec, table, patterns...);
+            }
+            else if constexpr (isIntervalDispatchV<Value, PatternPairs...>)
+            {
+                return dispatchIntervals(value, exec, table, patterns...);
+            }
+            else if constexpr (isStringDispatchV<Value, PatternPairs...>)
+            {
+                return dispatchStrings(value, exec, table, patterns...);
+            }
+            else if constexpr (isDsDispatchV<Value, PatternPairs...>)
+            {
+                if constexpr (std::is_same_v<Table, NoTable>)
+                {
+                    return dispatchDsInOrder(std::forward<Value>(value), exec, patterns...);
+                }
+                else
+                {
+                    return dispatchDs(std::forward<Value>(value), exec, table, patterns...);
+                }
+            }
+            else if constexpr (isVariantDispatchV<Value, PatternPairs...>)
+            {
+                return dispatchVariant(value, exec, patterns...);
+            }
+            else if constexpr (isKindDispatchV<Value, PatternPairs...>)
+            {
+                return dispatchKinds(value, exec, patterns...);
+            }
+            else
+            {
+                return (dispatchArm(std::forward<Value>(value), patterns, exec) ||
+                        ...);
+            }
+        }
+
+        // Whether the optimizer knows the keys, as for the literals written in the
+        // arms of a match once it is inlined. False when it cannot tell.
+        template <typename Key>
+        constexpr bool isKnown(Key const &key)
+        {
+            return MATCHIT_KNOWN(key);
+        }
+
+        template <typename Key, std::size_t nbKeys, std::size_t... I>
+        constexpr bool knownKeys(std::array<Key, nbKeys> const &keys, std::index_sequence<I...>)
+        {
+            return (isKnown(keys[I]) && ...);
+        }
+
+        template <typename Key, std::size_t nbKeys>
+        constexpr bool knownKeys(std::array<Key, nbKeys> const &keys)
+        {
+            return knownKeys(keys, std::make_index_sequence<nbKeys>{});
+        }
+
+        // The arms of the keys in order, then the wildcard arm after them if any,
+        // as the cases of a switch. Keys the optimizer knows fold into the code.
+        template <typename Value, typename Exec, typename Key, std::size_t nbKeys,
+                  typename Arms, std::size_t... I>
+        constexpr bool dispatchKeys(Value const &value, Exec const &exec,
+                                    std::array<Key, nbKeys> const &keys, Arms const &arms,
+                                    std::index_sequence<I...>)
+        {
+            auto const matchKey = [&value, &exec](Key const &key, auto const &arm)
+            {
+                auto const matched = keyMatches(key, value);
+                arm.count(matched);
+                return expect<std::decay_t<decltype(arm)>::kHINT>(matched) &&
+                       (exec(arm), true);
+            };
+            if constexpr (nbKeys < std::tuple_size_v<Arms>)
+            {
+                return (matchKey(keys[I], get<I>(arms)) || ...) ||
+                       (get<nbKeys>(arms).count(true), exec(get<nbKeys>(arms)), true);
+            }
+            else
+            {
+                return (matchKey(keys[I], get<I>(arms)) || ...);
+            }
+        }
+
+        template <typename Key, std::size_t nbKeys, std::size_t... I>
+        MATCHIT_INLINE constexpr bool ascendingKeys(std::array<Key, nbKeys> const &keys,
+                                                    std::index_sequence<I...>)
+        {
+            return ((keys[I] < keys[I + 1]) && ...);
+        }
+
+        template <std::size_t lo, std::size_t hi, typename Key, std::size_t nbKeys,
+                  typename Exec, typename Arms>
+        MATCHIT_INLINE constexpr bool searchKeys(Key const key,
+                                                 std::array<Key, nbKeys> const &keys,
+                                                 Exec const &exec, Arms const &arms)
+        {
+            if constexpr (hi - lo == 1)
+            {
+                return key == keys[lo] && callArm<lo>(exec, arms);
+            }
+            else
+            {
+                constexpr auto mid = lo + (hi - lo) / 2;
+                if (key < keys[mid])
+                {
+                    return searchKeys<lo, mid>(key, keys, exec, arms);
+                }
+                return searchKeys<mid, hi>(key, keys, exec, arms);
+            }
+        }
+
+        // Many known literals in ascending order, as in most opcode tables, are
+        // searched like the decision tree a compiler makes of a large switch.
+        // It is inlined whole, so the keys stay constants in the code and no
+        // table is built. Other keys are compared in arm order.
+        template <typename Value, typename Exec, typename Key, std::size_t nbKeys,
+                  typename Arms>
+        MATCHIT_INLINE constexpr bool dispatchKnownKeys(Value const &value, Exec const &exec,
+                                                        std::array<Key, nbKeys> const &keys,
+                                                        Arms const &arms)
+        {
+            if constexpr (nbKeys > kCHAINED_ARMS)
+            {
+                if (ascendingKeys(keys, std::make_index_sequence<nbKeys - 1>{}))
+                {
+                    if (searchKeys<0, nbKeys>(static_cast<Key>(literalKey(value)), keys, exec,
+                                              arms))
+                    {
+                        return true;
+                    }
+                    if constexpr (nbKeys < std::tuple_size_v<Arms>)
+                    {
+                        return callArm<nbKeys>(exec, arms);
+                    }
+                    else
+                    {
+                        return false;
+                    }
+                }
+            }
+            return dispatchKeys(value, exec, keys, arms, std::make_index_sequence<nbKeys>{});
+        }
+
+        [[noreturn]] MATCHIT_COLD inline void throwNoMatch()
+        {
+            throw std::logic_error{"Error: no patterns got matched!"};
+        }
+
+        // Uninitialized storage the winning handler constructs its result in, so
+        // results need not be default constructible and are moved only once.
+        template <typename T>
+        class ResultSlot
+        {
+        public:
+            ResultSlot() = default;
+            ResultSlot(ResultSlot const &) = delete;
+            ResultSlot &operator=(ResultSlot const &) = delete;
+            ~ResultSlot()
+            {
+                if (mConstructed)
+                {
+                    ptr()->~T();
+                }
+            }
+            template <typename Make>
+            void emplace(Make const &make)
+            {
+                ::new (static_cast<void *>(mStorage)) T(make());
+                mConstructed = true;
+            }
+            T take() { return std::move(*ptr()); }
+
+        private:
+            T *ptr() { return std::launder(reinterpret_cast<T *>(mStorage)); }
+            alignas(T) unsigned char mStorage[sizeof(T)];
+            bool mConstructed = false;
+        };
+
+        // The result is constructed in place by the winning handler.
+        template <typename RetType, typename Dispatch>
+        RetType runArmsInSlot(Dispatch const &dispatch)
+        {
+            ResultSlot<RetType> slot;
+            auto const exec = [&slot](auto const &pattern)
+            { slot.emplace([&pattern] { return pattern.execute(); }); };
+            bool const matched = dispatch(exec);
+            if (!MATCHIT_EXPECT(matched, 1))
+            {
+                throwNoMatch();
+            }
+            return slot.take();
+        }
+
+        // The result is default constructed then assigned, so that constant
+        // evaluation works.
+        template <typename RetType, typename Dispatch>
+        constexpr RetType runArmsAssigning(Dispatch const &dispatch)
+        {
+            RetType result{};
+            auto const exec = [&result](auto const &pattern) constexpr
+            { result = pattern.execute(); };
+            bool const matched = dispatch(exec);
+            if (!MATCHIT_EXPECT(matched, 1))
+            {
+                throwNoMatch();
+            }
+            return result;
+        }
+
+        // Runs the handler of the arm picked by dispatch(exec).
+        template <typename RetType, typename Dispatch>
+        constexpr auto runArms(Dispatch const &dispatch)
+        {
+            // expression, has return value.
+            if constexpr (!std::is_same_v<RetType, void> &&
+                          !(std::is_trivially_copyable_v<RetType> &&
+                            std::is_default_constructible_v<RetType>))
+            {
+                if constexpr (std::is_default_constructible_v<RetType> &&
+                              std::is_move_assignable_v<RetType>)
+                {
+                    if (isConstantEvaluated())
+                    {
+                        return runArmsAssigning<RetType>(dispatch);
+                    }
+                }
+                return runArmsInSlot<RetType>(dispatch);
+            }
+            else if constexpr (!std::is_same_v<RetType, void>)
+            {
+                return runArmsAssigning<RetType>(dispatch);
+            }
+            else
+            // statement, no return value, mismatching all patterns is not an error.
+            {
+                auto const exec = [](auto const &pattern)
+                { pattern.execute(); };
+                bool const matched = dispatch(exec);
+                static_cast<void>(matched);
+            }
+        }
+
+        template <typename... PatternPairs>
+        constexpr void forgetMemos(PatternPairs const &...patterns)
+        {
+            (processId(patterns.pattern(), 0, IdProcess::kFORGET), ...);
+        }
+
+        // Memos forget the subject when the match is over, also when a pattern
+        // throws.
+        template <typename... PatternPairs>
+        class MemoGuard
+        {
+        public:
+            explicit MemoGuard(PatternPairs const &...patterns) : mPatterns{patterns...} {}
+            MemoGuard(MemoGuard const &) = delete;
+            MemoGuard &operator=(MemoGuard const &) = delete;
+            ~MemoGuard()
+            {
+                std::apply([](auto const &...patterns) { forgetMemos(patterns...); },
+                           mPatterns);
+            }
+
+        private:
+            std::tuple<PatternPairs const &...> mPatterns;
+        };
+
+        // Runs just before the winning handler. Memos forget the subject, they
+        // only cache within one match.
+        // A temporary subject is handed to the arms as an lvalue, so that an arm
+        // failing after a binding cannot leave it moved from. Ids bind into it by
+        // address while the arms are tried and the handler runs, then those of
+        // the winning arm move what they bound into their own storage, which
+        // outlives the subject.
+        template <typename Value, typename Exec, typename... PatternPairs>
+        class BeforeHandler
+        {
+        public:
+            using SubjectT = std::remove_reference_t<Value>;
+
+            constexpr BeforeHandler(Exec const &exec, OwnedSubject const &subject,
+                                    PatternPairs const &...patterns)
+                : mExec{exec}, mSubject{subject}, mPatterns{patterns...}
+            {
+            }
+            template <typename PatternPair>
+            constexpr void operator()(PatternPair const &pattern) const
+            {
+                std::apply([](auto const &...patterns) { forgetMemos(patterns...); },
+                           mPatterns);
+                mExec(pattern);
+                if constexpr (!std::is_lvalue_reference_v<Value>)
+                {
+                    processId(pattern.pattern(), 0, IdProcess::kOWN);
+                }
+            }
+            constexpr OwnedSubject const &subject() const { return mSubject; }
+
+        private:
+            Exec const &mExec;
+            OwnedSubject mSubject;
+            std::tuple<PatternPairs const &...> mPatterns;
+        };
+
+        template <typename Value, typename Exec, typename... PatternPairs>
+        constexpr auto beforeHandler(Value &value, Exec const &exec,
+                                     PatternPairs const &...patterns)
+        {
+            auto subject = OwnedSubject{};
+            if constexpr (!std::is_lvalue_reference_v<Value>)
+            {
+                if (isConstantEvaluated())
+                {
+                    subject.mUnknown = true;
+                }
+                else
+                {
+                    subject = OwnedSubject{std::addressof(value),
+                                           &containsAddress<std::remove_reference_t<Value>>};
+                }
+            }
+            return BeforeHandler<Value, Exec, PatternPairs...>{exec, subject, patterns...};
+        }
+
+        template <typename Value, typename Exec, typename Table, typename... PatternPairs>
+        bool dispatchGuarded(Value &&value, Exec const &exec, Table const &table,
+                             PatternPairs const &...patterns)
+        {
+            MemoGuard<PatternPairs...> const guard{patterns...};
+            return dispatchPatterns(value, beforeHandler<Value>(value, exec, patterns...), table,
+                                    patterns...);
+        }
+
+        // Site is the table a matcher built with its arms, NoTable for the arms of
+        // a match, which are built on each call and get their table with them.
+        template <typename Value, typename Exec, typename Site, typename... PatternPairs>
+        constexpr bool dispatchMatchAt(Value &&value, Exec const &exec, Site const &site,
+                                       PatternPairs const &...patterns)
+        {
+            constexpr auto nbReadingArms =
+                (0 + ... + !std::is_same_v<typename PatternPairs::PatternT, Wildcard>);
+            if constexpr (isInputOnlyRange<Value>() && nbReadingArms > 1)
+            {
+                // each arm would go on reading where the one before it stopped.
+                static_assert((StreamReach<typename PatternPairs::PatternT>::kBOUNDED && ...),
+                              "Several arms read an input range only through ds patterns, "
+                              "and bind no ooo of it.");
+                auto buffer = StreamBuffer<
+                    std::remove_reference_t<Value>,
+                    std::max({std::size_t{0}, StreamReach<typename PatternPairs::PatternT>::kPREFIX...}),
+                    std::max({std::size_t{0}, StreamReach<typename PatternPairs::PatternT>::kSUFFIX...})>{
+                    value};
+                return dispatchMatchAt(buffer, exec, site, patterns...);
+            }
+            else if constexpr (!std::is_same_v<decltype(armKeys<Value>(patterns...)),
+                                               NoTable>)
+            {
+                // literals, intervals and string literals bind no Ids and use no
+                // memos.
+                if constexpr (isLiteralDispatchV<Value, PatternPairs...> &&
+                              std::is_same_v<Site, NoTable>)
+                {
+                    // literals the optimizer knows fold into the code, no table is
+                    // built for them.
+                    if (!isConstantEvaluated())
+                    {
+                        if (auto const keys = armKeys<Value>(patterns...); knownKeys(keys))
+                        {
+                            return dispatchKnownKeys(value, exec, keys,
+                                                     std::forward_as_tuple(patterns...));
+                        }
+                    }
+                }
+                else if constexpr (isIntervalDispatchV<Value, PatternPairs...> &&
+                                   std::is_same_v<Site, NoTable>)
+                {
+                    // a table built on each call would be sorted and checked for
+                    // every value. The bounds are compared in arm order instead.
+                    auto const keys = armKeys<Value>(patterns...);
+                    return dispatchKeys(
+                        value, exec, keys, std::forward_as_tuple(patterns...),
+                        std::make_index_sequence<std::tuple_size_v<decltype(keys)>>{});
+                }
+                else if constexpr (isStringDispatchV<Value, PatternPairs...> &&
+                                   std::is_same_v<Site, NoTable>)
+                {
+                    // a table built on each call would hash every literal. Their
+                    // sizes and boundary characters rule out all but one instead.
+                    auto const keys = armKeys<Value>(patterns...);
+                    return dispatchKeys(
+                        value, exec, keys, std::forward_as_tuple(patterns...),
+                        std::make_index_sequence<std::tuple_size_v<decltype(keys)>>{});
+                }
+                return dispatchPatterns(value, exec, tableAt<Value>(site, patterns...),
+                                        patterns...);
+            }
+            else if (isConstantEvaluated())
+            {
+                // memos are not constexpr, none to forget.
+                return dispatchPatterns(value, beforeHandler<Value>(value, exec, patterns...),
+                                        tableAt<Value>(site, patterns...), patterns...);
+            }
+            else
+            {
+                return dispatchGuarded(std::forward<Value>(value), exec,
+                                       tableAt<Value>(site, patterns...), patterns...);
+            }
+        }
+
+        template <typename Value, typename Exec, typename... PatternPairs>
+        constexpr bool dispatchMatch(Value &&value, Exec const &exec,
+                                     PatternPairs const &...patterns)
+        {
+            return dispatchMatchAt(std::forward<Value>(value), exec, NoTable{}, patterns...);
+        }
+
+        template <typename Value, typename... PatternPairs>
+        constexpr auto matchPatterns(Value &&value, PatternPairs const &...patterns)
+        {
+            using RetType = typename PatternPairsRetType<PatternPairs...>::RetType;
+            return runArms<RetType>(
+                [&value, &patterns...](auto const &exec) constexpr
+                { return dispatchMatch(std::forward<Value>(value), exec, patterns...); });
+        }
+
+        // The Ids of the winning arm are unbound once its handler returns, so that
+        // arms matched again bind them afresh.
+        template <typename Exec>
+        constexpr auto unbindAfter(Exec const &exec)
+        {
+            return [&exec](auto const &pattern) constexpr
+            {
+                exec(pattern);
+                processId(pattern.pattern(), 0, IdProcess::kCANCEL);
+            };
+        }
+
+        // Like matchPatterns, for the arms of a matcher, called again and again
+        // with the table built along with them. A value the table was built for
+        // picks its arm straight from the table, without a pattern pair per arm.
+        template <typename Value, typename Site, std::size_t... I, typename... Arms>
+        constexpr auto rematchPatterns(Value &&value, Site const &site,
+                                       ArmSlots<std::index_sequence<I...>, Arms...> const &arms)
+        {
+            using RetType =
+                typename PatternPairsRetType<decltype(std::declval<Arms const &>().pair())...>::RetType;
+            using TableT = decltype(dispatchTable<Value>(std::declval<Arms const &>().pair()...));
+            return runArms<RetType>(
+                [&value, &site, &arms](auto const &exec) constexpr
+                {
+                    if constexpr (!std::is_same_v<Site, NoTable> && std::is_same_v<TableT, Site> &&
+                                  !isDsDispatchV<Value, decltype(std::declval<Arms const &>()
+                                                                     .pair())...>)
+                    {
+                        constexpr auto nbArms = std::min(
+                            firstWildcardIdx<typename decltype(std::declval<Arms const &>()
+                                                                   .pair())::PatternT...>() +
+                                1,
+                            sizeof...(Arms));
+                        return dispatchIdx(findIdx(site, value), exec, arms,
+                                           std::make_index_sequence<nbArms>{});
+                    }
+                    else
+                    {
+                        return arms.apply(
+                            [&value, &exec, &site](auto const &...arm)
+                            {
+                                return dispatchMatchAt(std::forward<Value>(value),
+                                                       unbindAfter(exec), site, arm.pair()...);
+                            });
+                    }
+                });
+        }
+
+        // Like runArms, but a mismatch gives an empty std::optional, or false for
+        // statements, instead of throwing.
+        template <typename RetType, typename Dispatch>
+        constexpr auto tryRunArms(Dispatch const &dispatch)
+        {
+            if constexpr (!std::is_same_v<RetType, void>)
+            {
+                std::optional<RetType> result;
+                auto const exec = [&result](auto const &pattern) constexpr
+                { result.emplace(pattern.execute()); };
+                bool const matched = dispatch(exec);
+                if (MATCHIT_EXPECT(matched, 1))
+                {
+                    return result;
+                }
+                return std::optional<RetType>{};
+            }
+            else
+            {
+                auto const exec = [](auto const &pattern)
+                { pattern.execute(); };
+                bool const matched = dispatch(exec);
+                if (!MATCHIT_EXPECT(matched, 1))
+                {
+                    return false;
+                }
+                return true;
+            }
+        }
+
+        template <typename Value, typename... PatternPairs>
+        constexpr auto tryMatchPatterns(Value &&value, PatternPairs const &...patterns)
+        {
+            using RetType = typename PatternPairsRetType<PatternPairs...>::RetType;
+            return tryRunArms<RetType>(
+                [&value, &patterns...](auto const &exec) constexpr
+                { return dispatchMatch(std::forward<Value>(value), exec, patterns...); });
+        }
+
+        constexpr std::size_t kMAX_ADAPTIVE_ARMS = 16;
+
+        // The evaluation order of the disjoint arms of one match site, hottest
+        // first. The order is packed into one atomic word, four bits per arm, so
+        // readers always see a permutation while another thread reorders.
+        class AdaptiveOrder
+        {
+        public:
+            // The order is recomputed every period hits, and the counts are halved
+            // so that it follows a shifting mix.
+            explicit AdaptiveOrder(std::uint32_t period = 1024)
+                : mPeriod{std::max<std::uint32_t>(period, 1)} {}
+            AdaptiveOrder(AdaptiveOrder const &) = delete;
+            AdaptiveOrder &operator=(AdaptiveOrder const &) = delete;
+
+            std::uint64_t order() const { return mOrder.load(std::memory_order_relaxed); }
+            constexpr static std::size_t armAt(std::uint64_t order, std::size_t i)
+            {
+                return static_cast<std::size_t>((order >> (4 * i)) & 0xFU);
+            }
+            void hit(std::size_t arm, std::size_t nbArms)
+            {
+                mHits[arm].fetch_add(1, std::memory_order_relaxed);
+                if (mCalls.fetch_add(1, std::memory_order_relaxed) % mPeriod == mPeriod - 1)
+                {
+                    reorder(nbArms);
+                }
+            }
+
+        private:
+            void reorder(std::size_t nbArms)
+            {
+                std::array<std::uint32_t, kMAX_ADAPTIVE_ARMS> hits{};
+                std::array<std::size_t, kMAX_ADAPTIVE_ARMS> arms{};
+                auto const current = order();
+                for (std::size_t i = 0; i < kMAX_ADAPTIVE_ARMS; ++i)
+                {
+                    hits[i] = mHits[i].load(std::memory_order_relaxed);
+                    mHits[i].store(hits[i] / 2, std::memory_order_relaxed);
+                    arms[i] = armAt(current, i);
+                }
+                std::stable_sort(arms.begin(), arms.begin() + static_cast<std::ptrdiff_t>(nbArms),
+                                 [&hits](std::size_t lhs, std::size_t rhs)
+                                 { return hits[lhs] > hits[rhs]; });
+                std::uint64_t next = 0;
+                for (std::size_t i = 0; i < kMAX_ADAPTIVE_ARMS; ++i)
+                {
+                    next |= static_cast<std::uint64_t>(arms[i]) << (4 * i);
+                }
+                mOrder.store(next, std::memory_order_relaxed);
+            }
+
+            std::atomic<std::uint64_t> mOrder{0xFEDCBA9876543210U};
+            std::atomic<std::uint32_t> mCalls{};
+            std::array<std::atomic<std::uint32_t>, kMAX_ADAPTIVE_ARMS> mHits{};
+            std::uint32_t const mPeriod;
+        };
+
+        // as<T> and as<U> never both match: variant alternatives are exclusive,
+        // and a polymorphic object is at most one of two unrelated classes if
+        // one of them is final.
+        template <typename Value, typename T, typename U>
+        constexpr bool areDisjointTypes()
+        {
+            if constexpr (std::is_void_v<T> || std::is_void_v<U> || std::is_same_v<T, U>)
+            {
+                return false;
+            }
+            else if constexpr (!std::is_void_v<VariantBaseT<Value>>)
+            {
+                return true;
+            }
+            else
+            {
+                return (std::is_final_v<T> || std::is_final_v<U>) &&
+                       !std::is_base_of_v<T, U> && !std::is_base_of_v<U, T>;
+            }
+        }
+
+        template <typename Value, typename Types, std::size_t i, std::size_t... J>
+        constexpr bool isDisjointFromOthers(std::index_sequence<J...>)
+        {
+            return ((i == J || areDisjointTypes<Value, std::tuple_element_t<i, Types>,
+                                                std::tuple_element_t<J, Types>>()) &&
+                    ...);
+        }
+
+        template <typename Value, typename Types, std::size_t... I>
+        constexpr bool areDisjoint(std::index_sequence<I...> indices)
+        {
+            return (!std::is_void_v<std::tuple_element_t<I, Types>> && ...) &&
+                   (isDisjointFromOthers<Value, Types, I>(indices) && ...);
+        }
+
+        // The arms before the first wildcard are as<T> arms that can not match
+        // the same value, so they can be tried in any order.
+        template <typename Value, typename... PatternPairs>
+        constexpr bool areDisjointArmsV = areDisjoint<
+            std::decay_t<Value>, std::tuple<AsArmT<typename PatternPairs::PatternT>...>>(
+            std::make_index_sequence<firstWildcardIdx<typename PatternPairs::PatternT...>()>{});
+
+        template <std::size_t offset, typename Value, typename Exec, typename Arms,
+                  std::size_t... I>
+        constexpr bool dispatchArmAt(std::size_t idx, Value &value, Exec const &exec,
+                                     Arms const &arms, std::index_sequence<I...>)
+        {
+            return ((idx == offset + I &&
+                     dispatchArm(value, get<offset + I>(arms), exec)) ||
+                    ...);
+        }
+
+        template <std::size_t offset, typename Value, typename Exec, typename Arms,
+                  std::size_t... I>
+        constexpr bool dispatchArmsFrom(Value &value, Exec const &exec, Arms const &arms,
+                                        std::index_sequence<I...>)
+        {
+            return (dispatchArm(value, get<offset + I>(arms), exec) || ...);
+        }
+
+        template <typename Value, typename Exec, typename... PatternPairs>
+        bool dispatchAdaptive(AdaptiveOrder &order, Value &value, Exec const &exec,
+                              PatternPairs const &...patterns)
+        {
+            constexpr auto nbDisjoint = firstWildcardIdx<typename PatternPairs::PatternT...>();
+            auto const arms = std::forward_as_tuple(patterns...);
+            auto const packed = order.order();
+            for (std::size_t i = 0; i < nbDisjoint; ++i)
+            {
+                auto const idx = AdaptiveOrder::armAt(packed, i);
+                if (dispatchArmAt<0>(idx, value, exec, arms,
+                                                std::make_index_sequence<nbDisjoint>{}))
+                {
+                    order.hit(idx, nbDisjoint);
+                    return true;
+                }
+            }
+            // the wildcard and the arms after it keep their order.
+            return dispatchArmsFrom<nbDisjoint>(
+                value, exec, arms,
+                std::make_index_sequence<sizeof...(PatternPairs) - nbDisjoint>{});
+        }
+
+        // The disjoint arms tried hottest first, for runArms and tryRunArms.
+        template <typename Value, typename... PatternPairs>
+        auto adaptiveDispatch(AdaptiveOrder &order, std::remove_reference_t<Value> &value,
+                              PatternPairs const &...patterns)
+        {
+            static_assert(areDisjointArmsV<Value, PatternPairs...>,
+                          "Adaptive order needs as<T> arms that can not match the same value, "
+                          "followed by the wildcard arm if any.");
+            static_assert(firstWildcardIdx<typename PatternPairs::PatternT...>() <=
+                              kMAX_ADAPTIVE_ARMS,
+                          "Too many arms for an adaptive order.");
+            return [&order, &value, &patterns...](auto const &exec)
+            {
+                MemoGuard<PatternPairs...> const guard{patterns...};
+                return dispatchAdaptive(
+                    order, value, beforeHandler<Value>(value, exec, patterns...), patterns...);
+            };
+        }
+
+        // Like matchPatterns, but the disjoint arms are tried hottest first.
+        template <typename Value, typename... PatternPairs>
+        auto matchAdaptive(AdaptiveOrder &order, Value &&value, PatternPairs const &...patterns)
+        {
+            using RetType = typename PatternPairsRetType<PatternPairs...>::RetType;
+            return runArms<RetType>(adaptiveDispatch<Value>(order, value, patterns...));
+        }
+
+        // Like tryMatchPatterns, but the disjoint arms are tried hottest first.
+        template <typename Value, typename... PatternPairs>
+        auto tryMatchAdaptive(AdaptiveOrder &order, Value &&value,
+                              PatternPairs const &...patterns)
+        {
+            using RetType = typename PatternPairsRetType<PatternPairs...>::RetType;
+            return tryRunArms<RetType>(adaptiveDispatch<Value>(order, value, patterns...));
+        }
+
+        template <typename T>
+        class IsPatternPair : public std::false_type
+        {
+        };
+
+        template <typename Pattern, typename Func, Hint hint>
+        class IsPatternPair<PatternPair<Pattern, Func, hint>> : public std::true_type
+        {
+        };
+
+        constexpr std::size_t kBLOCK_SIZE = 64;
+
+        // Look up the arm indices of a block of elements first, then run the handlers.
+        template <typename Iter, typename Exec, typename Table, typename... PatternPairs>
+        constexpr Iter dispatchBlock(Iter first, Iter last, Exec const &exec,
+                                     Table const &table, PatternPairs const &...patterns)
+        {
+            constexpr auto nbArms =
+                std::min(firstWildcardIdx<typename PatternPairs::PatternT...>() + 1,
+                         sizeof...(PatternPairs));
+            auto const arms = std::forward_as_tuple(patterns...);
+            std::array<std::size_t, kBLOCK_SIZE> indices{};
+            std::size_t size = 0;
+            for (auto iter = first; size < kBLOCK_SIZE && iter != last; ++size, ++iter)
+            {
+                indices[size] = findIdx(table, *iter);
+            }
+            for (std::size_t i = 0; i < size; ++i, ++first)
+            {
+                dispatchIdx(indices[i], exec, arms, std::make_index_sequence<nbArms>{}) ||
+                    (exec.mismatch(), true);
+            }
+            return first;
+        }
+
+        // Memos only cache within the match of one element.
+        template <typename Value, typename Exec, typename Table, typename... PatternPairs>
+        bool dispatchForgetting(Value &&value, Exec const &exec, Table const &table,
+                                PatternPairs const &...patterns)
+        {
+            MemoGuard<PatternPairs...> const guard{patterns...};
+            return dispatchPatterns(value, exec, table, patterns...);
+        }
+
+        template <typename Range, typename Exec, typename... PatternPairs>
+        MATCHIT_INLINE constexpr void dispatchAll(Range &&range, Exec const &exec,
+                                   PatternPairs const &...patterns)
+        {
+            using Value = decltype(*std::begin(range));
+            using Iter = decltype(std::begin(range));
+            using Category = typename std::iterator_traits<Iter>::iterator_category;
+            auto first = std::begin(range);
+            auto const last = std::end(range);
+            if constexpr (isLiteralDispatchV<Value, PatternPairs...> &&
+                          !std::is_same_v<decltype(armKeys<Value>(patterns...)), NoTable>)
+            {
+                // literals the optimizer knows are tested in the loop, as a
+                // hand-written switch would, instead of looking them up in a table.
+                if (auto const keys = armKeys<Value>(patterns...); knownKeys(keys))
+                {
+                    auto const arms = std::forward_as_tuple(patterns...);
+                    for (; first != last; ++first)
+                    {
+                        dispatchKeys(*first, exec, keys, arms,
+                                     std::make_index_sequence<
+                                         std::tuple_size_v<std::decay_t<decltype(keys)>>>{}) ||
+                            (exec.mismatch(), true);
+                    }
+                    return;
+                }
+            }
+            auto const table = dispatchTable<Value>(patterns...);
+            if constexpr (!std::is_same_v<decltype(armKeys<Value>(patterns...)), NoTable> &&
+                          std::is_base_of_v<std::forward_iterator_tag, Category>)
+            {
+                while (first != last)
+                {
+                    first = dispatchBlock(first, last, exec, table, patterns...);
+                }
+            }
+            else
+            {
+                for (; first != last; ++first)
+                {
+                    (isConstantEvaluated()
+                         ? dispatchPatterns(*first, exec, table, patterns...)
+                         : dispatchForgetting(*first, exec, table, patterns...)) ||
+                        (exec.mismatch(), true);
+                }
+            }
+        }
+
+        template <typename Out>
+        class WriteResult
+        {
+        public:
+            mutable Out mOut;
+            template <typename PatternPair>
+            constexpr void operator()(PatternPair const &pattern) const
+            {
+                *mOut = pattern.execute();
+                ++mOut;
+                processId(pattern.pattern(), 0, IdProcess::kCANCEL);
+            }
+            constexpr void mismatch() const { throwNoMatch(); }
+        };
+
+        class ExecuteOnly
+        {
+        public:
+            template <typename PatternPair>
+            constexpr void operator()(PatternPair const &pattern) const
+            {
+                pattern.execute();
+                processId(pattern.pattern(), 0, IdProcess::kCANCEL);
+            }
+            constexpr void mismatch() const {}
+        };
+
+        // Match every element of a range. Results are written to out, or with
+        // statement handlers, out is the first arm. The arms and the tables built
+        // from them are set up only once.
+        template <typename Range, typename Out, typename... PatternPairs>
+        MATCHIT_INLINE constexpr auto matchAll(Range &&range, Out out, PatternPairs const &...patterns)
+        {
+            if constexpr (IsPatternPair<Out>::value)
+            {
+                dispatchAll(std::forward<Range>(range), ExecuteOnly{}, out, patterns...);
+            }
+            else
+            {
+                auto const exec = WriteResult<Out>{out};
+                dispatchAll(std::forward<Range>(range), exec, patterns...);
+                return exec.mOut;
+            }
+        }
+
+#ifdef MATCHIT_PARALLEL
+        constexpr std::size_t kCHUNK_SIZE = 64 * kBLOCK_SIZE;
+
+        // The chunks [mNext, mLast) of a range handed to one worker. Idle workers
+        // steal from the same counter, so every chunk is taken exactly once.
+        class alignas(64) ChunkQueue
+        {
+        public:
+            std::atomic<std::size_t> mNext{};
+            std::size_t mLast{};
+            bool pop(std::size_t &chunk)
+            {
+                chunk = mNext.fetch_add(1, std::memory_order_relaxed);
+                return chunk < mLast;
+            }
+        };
+
+        // Threads kept between parallelMatchAll calls, started on first demand.
+        // A task is tagged with the call that posted it, which withdraws the ones
+        // still queued once its own thread ran out of chunks, so that calls nested
+        // in a task never wait for a task queued behind them.
+        class WorkerPool
+        {
+        public:
+            static WorkerPool &instance()
+            {
+                static WorkerPool pool;
+                return pool;
+            }
+            WorkerPool(WorkerPool const &) = delete;
+            WorkerPool &operator=(WorkerPool const &) = delete;
+            ~WorkerPool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock{mMutex};
+                    mStop = true;
+                }
+                mWake.notify_all();
+                for (auto &thread : mThreads)
+                {
+                    thread.join();
+                }
+            }
+            // Starts threads until there are at least nbThreads.
+            void reserve(std::size_t nbThreads)
+            {
+                std::lock_guard<std::mutex> lock{mMutex};
+                while (mThreads.size() < nbThreads)
+                {
+                    mThreads.emplace_back([this] { run(); });
+                }
+            }
+            void post(void const *owner, std::function<void()> task)
+            {
+                {
+                    std::lock_guard<std::mutex> lock{mMutex};
+                    mTasks.push_back(Task{owner, std::move(task)});
+                }
+                mWake.notify_one();
+            }
+            // Drops the queued tasks of owner, returns how many.
+            std::size_t withdraw(void const *owner)
+            {
+                std::lock_guard<std::mutex> lock{mMutex};
+                auto const size = mTasks.size();
+                mTasks.erase(std::remove_if(mTasks.begin(), mTasks.end(),
+                                            [owner](Task const &task)
+                                            { return task.mOwner == owner; }),
+                             mTasks.end());
+                return size - mTasks.size();
+            }
+
+        private:
+            class Task
+            {
+            public:
+                void const *mOwner;
+                std::function<void()> mRun;
+            };
+
+            WorkerPool() = default;
+            void run()
+            {
+                while (true)
+                {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock{mMutex};
+                        mWake.wait(lock, [this] { return mStop || !mTasks.empty(); });
+                        if (mTasks.empty())
+                        {
+                            return;
+                        }
+                        task = std::move(mTasks.front().mRun);
+                        mTasks.pop_front();
+                    }
+                    task();
+                }
+            }
+
+            std::mutex mMutex;
+            std::condition_variable mWake;
+            std::deque<Task> mTasks;
+            std::vector<std::thread> mThreads;
+            bool mStop = false;
+        };
+
+        // matchAll split across nbThreads workers, the calling thread being one of
+        // them and the others taken from a WorkerPool. Each worker builds its own
+        // matcher with makeMatcher, so Ids are never shared between threads, and
+        // writes to its own part of out. The first exception thrown by a worker
+        // stops the others and is rethrown.
+        template <typename Range, typename Out, typename MakeMatcher>
+        void parallelMatchAll(Range &&range, Out out, MakeMatcher const &makeMatcher,
+                              std::size_t nbThreads = std::thread::hardware_concurrency())
+        {
+            using Iter = decltype(std::begin(range));
+            static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                                            typename std::iterator_traits<Iter>::iterator_category>,
+                          "parallelMatchAll needs a random access range.");
+            static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                                            typename std::iterator_traits<Out>::iterator_category>,
+                          "parallelMatchAll writes to preallocated, random access output.");
+            using InDiff = typename std::iterator_traits<Iter>::difference_type;
+            using OutDiff = typename std::iterator_traits<Out>::difference_type;
+            auto const first = std::begin(range);
+            auto const size = static_cast<std::size_t>(std::distance(first, std::end(range)));
+            auto const nbChunks = (size + kCHUNK_SIZE - 1) / kCHUNK_SIZE;
+            auto const nbWorkers = std::max<std::size_t>(1, std::min(nbThreads, nbChunks));
+            std::vector<ChunkQueue> queues(nbWorkers);
+            for (std::size_t i = 0; i < nbWorkers; ++i)
+            {
+                queues[i].mNext = i * nbChunks / nbWorkers;
+                queues[i].mLast = (i + 1) * nbChunks / nbWorkers;
+            }
+
+            std::atomic<bool> failed{false};
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable done;
+            std::size_t pending = 0;
+            auto const fail = [&]
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                failed = true;
+            };
+            auto const work = [&](std::size_t self)
+            {
+                try
+                {
+                    auto const m = makeMatcher();
+                    // own chunks first, then the ones left to the others.
+                    for (std::size_t i = 0; i < nbWorkers; ++i)
+                    {
+                        auto &queue = queues[(self + i) % nbWorkers];
+                        std::size_t chunk = 0;
+                        while (!failed.load(std::memory_order_relaxed) && queue.pop(chunk))
+                        {
+                            auto const begin = chunk * kCHUNK_SIZE;
+                            auto const end = std::min(size, begin + kCHUNK_SIZE);
+                            m.all(makeSubrange(std::next(first, static_cast<InDiff>(begin)),
+                                               std::next(first, static_cast<InDiff>(end))),
+                                  std::next(out, static_cast<OutDiff>(begin)));
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    fail();
+                }
+            };
+
+            auto &pool = WorkerPool::instance();
+            try
+            {
+                pool.reserve(nbWorkers - 1);
+                for (std::size_t i = 1; i < nbWorkers; ++i)
+                {
+                    pool.post(&queues,
+                              [&, i]
+                              {
+                                  work(i);
+                                  std::lock_guard<std::mutex> lock{mutex};
+                                  --pending;
+                                  done.notify_one();
+                              });
+                    // a task may finish before it is counted, pending wraps then.
+                    std::lock_guard<std::mutex> lock{mutex};
+                    ++pending;
+                }
+            }
+            catch (...)
+            {
+                fail();
+            }
+            work(0);
+            {
+                auto const withdrawn = pool.withdraw(&queues);
+                std::unique_lock<std::mutex> lock{mutex};
+                pending -= withdrawn;
+                done.wait(lock, [&pending] { return pending == 0; });
+            }
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+#endif // MATCHIT_PARALLEL
+
+    } // namespace impl
+
+    // export symbols
+    using impl::_;
+    using impl::AdaptiveOrder;
+    using impl::and_;
+    using impl::app;
+    using impl::Auto;
+    using impl::be;
+    using impl::bin;
+    using impl::bits;
+    using impl::ByRef;
+    using impl::ByValue;
+    using impl::ds;
+    using impl::endsWith;
+    using impl::Id;
+    using impl::KindTraits;
+    using impl::le;
+    using impl::matchAll;
+    using impl::memo;
+    using impl::Memo;
+    using impl::meet;
+    using impl::not_;
+    using impl::ooo;
+    using impl::or_;
+#ifdef MATCHIT_PARALLEL
+    using impl::parallelMatchAll;
+#endif
     using impl::pattern;
+    using impl::PerCall;
+    using impl::splitAt;
+    using impl::startsWith;
     using impl::Subrange;
     using impl::SubrangeT;
     using impl::when;
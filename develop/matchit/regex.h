@@ -0,0 +1,925 @@
+#ifndef MATCHIT_REGEX_H
+#define MATCHIT_REGEX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace matchit
+{
+    namespace impl
+    {
+        constexpr std::size_t toByte(char const c) { return static_cast<unsigned char>(c); }
+
+        class ByteSet
+        {
+        public:
+            constexpr void add(std::size_t const byte)
+            {
+                mBits[byte / 64] |= uint64_t{1} << (byte % 64);
+            }
+            constexpr void addRange(std::size_t const low, std::size_t const high)
+            {
+                for (auto byte = low; byte <= high; ++byte)
+                {
+                    add(byte);
+                }
+            }
+            constexpr void merge(ByteSet const &other)
+            {
+                for (std::size_t i = 0; i < mBits.size(); ++i)
+                {
+                    mBits[i] |= other.mBits[i];
+                }
+            }
+            constexpr void negate()
+            {
+                for (auto &word : mBits)
+                {
+                    word = ~word;
+                }
+            }
+            constexpr bool test(std::size_t const byte) const
+            {
+                return ((mBits[byte / 64] >> (byte % 64)) & 1U) != 0;
+            }
+
+        private:
+            std::array<uint64_t, 4> mBits{};
+        };
+
+        enum class RegexNodeKind
+        {
+            kEMPTY,
+            kSET,
+            kCONCAT,
+            kALT,
+            kSTAR,
+            kPLUS,
+            kQUEST,
+            kGROUP
+        };
+
+        // a and b are the children, the set of kSET or the group index of kGROUP,
+        // 0 for non-capturing groups.
+        class RegexNode
+        {
+        public:
+            RegexNodeKind kind = RegexNodeKind::kEMPTY;
+            std::size_t a = 0;
+            std::size_t b = 0;
+            bool lazy = false;
+        };
+
+        // Parses the supported syntax into a tree: literals, '.', escapes (\d \w \s,
+        // their negations, \n \t \r and escaped punctuation), bracket expressions,
+        // groups, (?:...), '|', the greedy and lazy '*', '+' and '?', and '^' / '$'
+        // at the ends. Errors are thrown, at compile time they fail the build.
+        template <std::size_t N>
+        class RegexParser
+        {
+        public:
+            constexpr static std::size_t kMAX_NODES = 3 * N;
+
+            constexpr explicit RegexParser(std::string_view const source) : mSource{source}
+            {
+                mRoot = parseAlternation();
+                if (!atEnd())
+                {
+                    throw std::logic_error("regex: unbalanced ')'.");
+                }
+            }
+            constexpr RegexNode const &node(std::size_t const idx) const { return mNodes[idx]; }
+            constexpr auto const &sets() const { return mSets; }
+            constexpr std::size_t nbSets() const { return mNbSets; }
+            constexpr std::size_t nbGroups() const { return mNbGroups; }
+            constexpr std::size_t root() const { return mRoot; }
+
+        private:
+            constexpr static std::size_t kNONE = ~std::size_t{0};
+
+            constexpr bool atEnd() const { return mPos == mSource.size(); }
+            constexpr char peek() const { return mSource[mPos]; }
+
+            constexpr std::size_t addNode(RegexNodeKind const kind, std::size_t const a = 0,
+                                          std::size_t const b = 0, bool const lazy = false)
+            {
+                if (mNbNodes == kMAX_NODES)
+                {
+                    throw std::logic_error("regex: too complex.");
+                }
+                mNodes[mNbNodes] = RegexNode{kind, a, b, lazy};
+                return mNbNodes++;
+            }
+            constexpr std::size_t addSet(ByteSet const &set)
+            {
+                mSets[mNbSets] = set;
+                return addNode(RegexNodeKind::kSET, mNbSets++);
+            }
+
+            constexpr std::size_t parseAlternation()
+            {
+                auto node = parseConcatenation();
+                while (!atEnd() && peek() == '|')
+                {
+                    ++mPos;
+                    auto const rhs = parseConcatenation();
+                    node = addNode(RegexNodeKind::kALT, node, rhs);
+                }
+                return node;
+            }
+            constexpr std::size_t parseConcatenation()
+            {
+                auto node = kNONE;
+                while (!atEnd() && peek() != '|' && peek() != ')')
+                {
+                    auto const item = parseRepetition();
+                    node = node == kNONE ? item : addNode(RegexNodeKind::kCONCAT, node, item);
+                }
+                return node == kNONE ? addNode(RegexNodeKind::kEMPTY) : node;
+            }
+            constexpr std::size_t parseRepetition()
+            {
+                auto node = parseAtom();
+                while (!atEnd() && (peek() == '*' || peek() == '+' || peek() == '?'))
+                {
+                    auto const kind = peek() == '*'   ? RegexNodeKind::kSTAR
+                                      : peek() == '+' ? RegexNodeKind::kPLUS
+                                                      : RegexNodeKind::kQUEST;
+                    ++mPos;
+                    auto const lazy = !atEnd() && peek() == '?';
+                    if (lazy)
+                    {
+                        ++mPos;
+                    }
+                    node = addNode(kind, node, 0, lazy);
+                }
+                return node;
+            }
+            constexpr std::size_t parseAtom()
+            {
+                auto const c = mSource[mPos++];
+                switch (c)
+                {
+                case '(':
+                {
+                    auto group = std::size_t{0};
+                    if (mSource.substr(mPos, 2) == "?:")
+                    {
+                        mPos += 2;
+                    }
+                    else
+                    {
+                        group = ++mNbGroups;
+                    }
+                    auto const child = parseAlternation();
+                    if (atEnd() || peek() != ')')
+                    {
+                        throw std::logic_error("regex: unbalanced '('.");
+                    }
+                    ++mPos;
+                    return addNode(RegexNodeKind::kGROUP, child, group);
+                }
+                case '.':
+                {
+                    auto set = ByteSet{};
+                    set.add(toByte('\n'));
+                    set.negate();
+                    return addSet(set);
+                }
+                case '[':
+                    return addSet(parseBracket());
+                case '\\':
+                    return addSet(parseEscape());
+                case '^':
+                    if (mPos != 1)
+                    {
+                        throw std::logic_error("regex: '^' is only supported first.");
+                    }
+                    return addNode(RegexNodeKind::kEMPTY);
+                case '$':
+                    if (!atEnd())
+                    {
+                        throw std::logic_error("regex: '$' is only supported last.");
+                    }
+                    return addNode(RegexNodeKind::kEMPTY);
+                case '*':
+                case '+':
+                case '?':
+                    throw std::logic_error("regex: nothing to repeat.");
+                case '{':
+                case '}':
+                    throw std::logic_error("regex: counted repetition is not supported.");
+                default:
+                {
+                    auto set = ByteSet{};
+                    set.add(toByte(c));
+                    return addSet(set);
+                }
+                }
+            }
+            constexpr ByteSet parseEscape()
+            {
+                if (atEnd())
+                {
+                    throw std::logic_error("regex: trailing '\\'.");
+                }
+                auto const c = mSource[mPos++];
+                auto set = ByteSet{};
+                switch (c)
+                {
+                case 'd':
+                case 'D':
+                    set.addRange(toByte('0'), toByte('9'));
+                    break;
+                case 'w':
+                case 'W':
+                    set.addRange(toByte('0'), toByte('9'));
+                    set.addRange(toByte('A'), toByte('Z'));
+                    set.addRange(toByte('a'), toByte('z'));
+                    set.add(toByte('_'));
+                    break;
+                case 's':
+                case 'S':
+                    set.add(toByte(' '));
+                    set.addRange(toByte('\t'), toByte('\r'));
+                    break;
+                case 'n':
+                    set.add(toByte('\n'));
+                    return set;
+                case 't':
+                    set.add(toByte('\t'));
+                    return set;
+                case 'r':
+                    set.add(toByte('\r'));
+                    return set;
+                default:
+                    if (('0' <= c && c <= '9') || ('A' <= c && c <= 'Z') ||
+                        ('a' <= c && c <= 'z'))
+                    {
+                        throw std::logic_error("regex: unknown escape.");
+                    }
+                    set.add(toByte(c));
+                    return set;
+                }
+                if (c == 'D' || c == 'W' || c == 'S')
+                {
+                    set.negate();
+                }
+                return set;
+            }
+            constexpr ByteSet parseBracket()
+            {
+                auto set = ByteSet{};
+                auto const negated = !atEnd() && peek() == '^';
+                if (negated)
+                {
+                    ++mPos;
+                }
+                // a ']' right after '[' or '[^' is a literal.
+                for (auto first = true;; first = false)
+                {
+                    if (atEnd())
+                    {
+                        throw std::logic_error("regex: unbalanced '['.");
+                    }
+                    auto const c = mSource[mPos++];
+                    if (c == ']' && !first)
+                    {
+                        break;
+                    }
+                    if (c == '\\')
+                    {
+                        set.merge(parseEscape());
+                    }
+                    else if (mPos + 1 < mSource.size() && peek() == '-' &&
+                             mSource[mPos + 1] != ']')
+                    {
+                        auto const high = mSource[mPos + 1];
+                        mPos += 2;
+                        if (toByte(high) < toByte(c))
+                        {
+                            throw std::logic_error("regex: invalid range.");
+                        }
+                        set.addRange(toByte(c), toByte(high));
+                    }
+                    else
+                    {
+                        set.add(toByte(c));
+                    }
+                }
+                if (negated)
+                {
+                    set.negate();
+                }
+                return set;
+            }
+
+            std::string_view mSource;
+            std::size_t mPos = 0;
+            std::array<RegexNode, kMAX_NODES> mNodes{};
+            std::size_t mNbNodes = 0;
+            std::array<ByteSet, N> mSets{};
+            std::size_t mNbSets = 0;
+            std::size_t mNbGroups = 0;
+            std::size_t mRoot = 0;
+        };
+
+        enum class RegexOp
+        {
+            kSET,
+            kSPLIT,
+            kJMP,
+            kSAVE,
+            kMATCH
+        };
+
+        // kSET consumes a byte of set x, kSPLIT continues at x then at y, kJMP at x,
+        // kSAVE records the position in slot x.
+        class RegexInstr
+        {
+        public:
+            RegexOp op = RegexOp::kMATCH;
+            std::size_t x = 0;
+            std::size_t y = 0;
+        };
+
+        template <std::size_t N>
+        class Regex;
+
+        // Refers to a named automaton, kREGEX and constexpr variables included, or owns
+        // the one it was made from when that was a temporary.
+        template <std::size_t N, bool owned, typename... Patterns>
+        class RegexPattern
+        {
+            using AutomatonT = std::conditional_t<owned, Regex<N>, Regex<N> const *>;
+
+        public:
+            constexpr explicit RegexPattern(AutomatonT regex, Patterns const &...patterns)
+                : mRegex{std::move(regex)}, mPatterns{patterns...}
+            {
+            }
+            constexpr Regex<N> const &regex() const
+            {
+                if constexpr (owned)
+                {
+                    return mRegex;
+                }
+                else
+                {
+                    return *mRegex;
+                }
+            }
+            constexpr auto const &patterns() const { return mPatterns; }
+
+        private:
+            AutomatonT mRegex;
+            std::tuple<Patterns...> mPatterns;
+        };
+
+        // A regular expression over N - 1 chars compiled to a Thompson NFA and to a
+        // DFA over byte classes. The whole string must match, the DFA decides that in
+        // one table lookup per char. Capture groups are then found by running the
+        // NFA, only over strings known to match. If the DFA would exceed its states
+        // budget the NFA alone is used.
+        // Built in a constexpr variable the automata are computed at compile time.
+        template <std::size_t N>
+        class Regex
+        {
+            constexpr static std::size_t kMAX_INSTRS = 2 * N;
+            constexpr static std::size_t kMAX_STATES = 2 * N + 2;
+            constexpr static std::size_t kMAX_CLASSES = 4 * N + 1 < 256 ? 4 * N + 1 : 256;
+            constexpr static std::size_t kWORDS = (kMAX_INSTRS + 63) / 64;
+            using StateT = std::conditional_t<kMAX_STATES <= 256, uint8_t, uint16_t>;
+            using StateSet = std::array<uint64_t, kWORDS>;
+
+        public:
+            constexpr explicit Regex(char const (&source)[N])
+            {
+                auto const parser = RegexParser<N>{std::string_view{source, N - 1}};
+                mSets = parser.sets();
+                mNbSets = parser.nbSets();
+                mNbGroups = parser.nbGroups();
+                emit(parser, parser.root());
+                addInstr(RegexInstr{RegexOp::kMATCH});
+                buildDfa();
+            }
+
+            constexpr std::size_t nbGroups() const { return mNbGroups; }
+
+            // Patterns are matched against the capture groups, in order, as
+            // std::string_views over the subject. Groups that took no part in the
+            // match are empty views. The pattern refers to this automaton, which has
+            // to outlive it, unless this is a temporary.
+            template <typename... Patterns>
+            constexpr auto operator()(Patterns &&...patterns) const &
+            {
+                checkNbPatterns(sizeof...(Patterns));
+                return RegexPattern<N, false, StringPatternT<Patterns>...>{
+                    this, stringPattern(patterns)...};
+            }
+            template <typename... Patterns>
+            constexpr auto operator()(Patterns &&...patterns) &&
+            {
+                checkNbPatterns(sizeof...(Patterns));
+                return RegexPattern<N, true, StringPatternT<Patterns>...>{
+                    std::move(*this), stringPattern(patterns)...};
+            }
+
+            constexpr bool matches(std::string_view const str) const
+            {
+                if (!mHasDfa)
+                {
+                    auto groups = std::array<std::string_view, 0>{};
+                    return capture(str, groups);
+                }
+                std::size_t state = 1;
+                for (auto const c : str)
+                {
+                    state = mTable[state * kMAX_CLASSES + mClassOf[toByte(c)]];
+                    if (state == 0)
+                    {
+                        return false;
+                    }
+                }
+                return mAccepting[state];
+            }
+
+            // Leftmost-greedy captures of the first nbCaptures groups, false if str
+            // does not match.
+            template <std::size_t nbCaptures>
+            constexpr bool capture(std::string_view const str,
+                                   std::array<std::string_view, nbCaptures> &groups) const
+            {
+                using Slots = std::array<std::size_t, 2 * nbCaptures + 2>;
+                if (!isConstantEvaluated())
+                {
+                    return captureAtRuntime(str, groups);
+                }
+                auto lists = std::array<Threads<Slots>, 2>{};
+                return runThreads(str, groups, lists);
+            }
+
+        private:
+            constexpr void checkNbPatterns(std::size_t nbPatterns) const
+            {
+                if (nbPatterns > mNbGroups)
+                {
+                    throw std::logic_error("regex: more patterns than capture groups.");
+                }
+            }
+
+            template <typename Slots>
+            class Threads
+            {
+            public:
+                std::array<std::size_t, kMAX_INSTRS> pcs;
+                std::array<Slots, kMAX_INSTRS> slots;
+                // pos + 1 for instructions already added at pos.
+                std::array<std::size_t, kMAX_INSTRS> marks{};
+                std::size_t size = 0;
+            };
+
+            // Only the marks need clearing, zeroing the threads would cost more than
+            // running them on short strings.
+            template <std::size_t nbCaptures>
+            bool captureAtRuntime(std::string_view const str,
+                                  std::array<std::string_view, nbCaptures> &groups) const
+            {
+                std::array<Threads<std::array<std::size_t, 2 * nbCaptures + 2>>, 2> lists;
+                return runThreads(str, groups, lists);
+            }
+
+            // The Pike VM: threads advance in lockstep, in priority order.
+            template <std::size_t nbCaptures, typename Lists>
+            constexpr bool runThreads(std::string_view const str,
+                                      std::array<std::string_view, nbCaptures> &groups,
+                                      Lists &lists) const
+            {
+                using Slots = std::array<std::size_t, 2 * nbCaptures + 2>;
+                auto slots = Slots{};
+                for (auto &slot : slots)
+                {
+                    slot = std::string_view::npos;
+                }
+                addThread(lists[0], 0, slots, 0);
+                for (std::size_t pos = 0;; ++pos)
+                {
+                    auto &current = lists[pos % 2];
+                    auto &next = lists[(pos + 1) % 2];
+                    next.size = 0;
+                    for (std::size_t t = 0; t < current.size; ++t)
+                    {
+                        auto const &instr = mInstrs[current.pcs[t]];
+                        if (instr.op == RegexOp::kMATCH)
+                        {
+                            // threads after this one have a lower priority.
+                            if (pos == str.size())
+                            {
+                                fillGroups(str, current.slots[t], groups);
+                                return true;
+                            }
+                        }
+                        else if (pos < str.size() && mSets[instr.x].test(toByte(str[pos])))
+                        {
+                            addThread(next, current.pcs[t] + 1, current.slots[t], pos + 1);
+                        }
+                    }
+                    if (pos == str.size() || next.size == 0)
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            constexpr static bool testBit(StateSet const &set, std::size_t const idx)
+            {
+                return ((set[idx / 64] >> (idx % 64)) & 1U) != 0;
+            }
+            constexpr static void setBit(StateSet &set, std::size_t const idx)
+            {
+                set[idx / 64] |= uint64_t{1} << (idx % 64);
+            }
+            constexpr static bool sameSet(StateSet const &lhs, StateSet const &rhs)
+            {
+                for (std::size_t w = 0; w < kWORDS; ++w)
+                {
+                    if (lhs[w] != rhs[w])
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            constexpr std::size_t addInstr(RegexInstr const &instr)
+            {
+                if (mNbInstrs == kMAX_INSTRS)
+                {
+                    throw std::logic_error("regex: too complex.");
+                }
+                mInstrs[mNbInstrs] = instr;
+                return mNbInstrs++;
+            }
+            // greedy repetitions try one more iteration first.
+            constexpr void branch(std::size_t const split, std::size_t const more,
+                                  std::size_t const done, bool const lazy)
+            {
+                mInstrs[split].x = lazy ? done : more;
+                mInstrs[split].y = lazy ? more : done;
+            }
+            constexpr void emit(RegexParser<N> const &parser, std::size_t const idx)
+            {
+                auto const node = parser.node(idx);
+                switch (node.kind)
+                {
+                case RegexNodeKind::kEMPTY:
+                    break;
+                case RegexNodeKind::kSET:
+                    addInstr(RegexInstr{RegexOp::kSET, node.a});
+                    break;
+                case RegexNodeKind::kCONCAT:
+                    emit(parser, node.a);
+                    emit(parser, node.b);
+                    break;
+                case RegexNodeKind::kALT:
+                {
+                    auto const split = addInstr(RegexInstr{RegexOp::kSPLIT});
+                    mInstrs[split].x = mNbInstrs;
+                    emit(parser, node.a);
+                    auto const jmp = addInstr(RegexInstr{RegexOp::kJMP});
+                    mInstrs[split].y = mNbInstrs;
+                    emit(parser, node.b);
+                    mInstrs[jmp].x = mNbInstrs;
+                    break;
+                }
+                case RegexNodeKind::kSTAR:
+                {
+                    auto const split = addInstr(RegexInstr{RegexOp::kSPLIT});
+                    emit(parser, node.a);
+                    addInstr(RegexInstr{RegexOp::kJMP, split});
+                    branch(split, split + 1, mNbInstrs, node.lazy);
+                    break;
+                }
+                case RegexNodeKind::kPLUS:
+                {
+                    auto const begin = mNbInstrs;
+                    emit(parser, node.a);
+                    auto const split = addInstr(RegexInstr{RegexOp::kSPLIT});
+                    branch(split, begin, mNbInstrs, node.lazy);
+                    break;
+                }
+                case RegexNodeKind::kQUEST:
+                {
+                    auto const split = addInstr(RegexInstr{RegexOp::kSPLIT});
+                    emit(parser, node.a);
+                    branch(split, split + 1, mNbInstrs, node.lazy);
+                    break;
+                }
+                case RegexNodeKind::kGROUP:
+                    if (node.b == 0)
+                    {
+                        emit(parser, node.a);
+                    }
+                    else
+                    {
+                        addInstr(RegexInstr{RegexOp::kSAVE, 2 * node.b});
+                        emit(parser, node.a);
+                        addInstr(RegexInstr{RegexOp::kSAVE, 2 * node.b + 1});
+                    }
+                    break;
+                }
+            }
+
+            // The kSET and kMATCH instructions reachable from pc without input.
+            constexpr StateSet closure(std::size_t const pc) const
+            {
+                auto set = StateSet{};
+                auto seen = StateSet{};
+                auto stack = std::array<std::size_t, 2 * kMAX_INSTRS + 1>{};
+                std::size_t top = 0;
+                stack[top++] = pc;
+                while (top != 0)
+                {
+                    auto const cur = stack[--top];
+                    if (testBit(seen, cur))
+                    {
+                        continue;
+                    }
+                    setBit(seen, cur);
+                    auto const &instr = mInstrs[cur];
+                    switch (instr.op)
+                    {
+                    case RegexOp::kSET:
+                    case RegexOp::kMATCH:
+                        setBit(set, cur);
+                        break;
+                    case RegexOp::kJMP:
+                        stack[top++] = instr.x;
+                        break;
+                    case RegexOp::kSPLIT:
+                        stack[top++] = instr.y;
+                        stack[top++] = instr.x;
+                        break;
+                    case RegexOp::kSAVE:
+                        stack[top++] = cur + 1;
+                        break;
+                    }
+                }
+                return set;
+            }
+
+            // Bytes in the same sets share a class, the DFA has one column per class.
+            constexpr void buildClasses(std::array<std::size_t, kMAX_CLASSES> &classRep)
+            {
+                for (std::size_t byte = 0; byte < 256; ++byte)
+                {
+                    std::size_t cls = 0;
+                    for (; cls < mNbClasses; ++cls)
+                    {
+                        auto same = true;
+                        for (std::size_t s = 0; s < mNbSets && same; ++s)
+                        {
+                            same = mSets[s].test(byte) == mSets[s].test(classRep[cls]);
+                        }
+                        if (same)
+                        {
+                            break;
+                        }
+                    }
+                    if (cls == mNbClasses)
+                    {
+                        if (cls == kMAX_CLASSES)
+                        {
+                            throw std::logic_error("regex: too many byte classes.");
+                        }
+                        classRep[cls] = byte;
+                        ++mNbClasses;
+                    }
+                    mClassOf[byte] = static_cast<uint8_t>(cls);
+                }
+            }
+
+            // Subset construction, state 0 is the dead state and 1 the start.
+            constexpr void buildDfa()
+            {
+                auto classRep = std::array<std::size_t, kMAX_CLASSES>{};
+                buildClasses(classRep);
+                auto next = std::array<StateSet, kMAX_INSTRS>{};
+                for (std::size_t pc = 0; pc < mNbInstrs; ++pc)
+                {
+                    if (mInstrs[pc].op == RegexOp::kSET)
+                    {
+                        next[pc] = closure(pc + 1);
+                    }
+                }
+                auto states = std::array<StateSet, kMAX_STATES>{};
+                states[1] = closure(0);
+                std::size_t nbStates = 2;
+                for (std::size_t state = 1; state < nbStates; ++state)
+                {
+                    mAccepting[state] = testBit(states[state], mNbInstrs - 1);
+                    for (std::size_t cls = 0; cls < mNbClasses; ++cls)
+                    {
+                        auto target = StateSet{};
+                        for (std::size_t pc = 0; pc < mNbInstrs; ++pc)
+                        {
+                            if (testBit(states[state], pc) && mInstrs[pc].op == RegexOp::kSET &&
+                                mSets[mInstrs[pc].x].test(classRep[cls]))
+                            {
+                                for (std::size_t w = 0; w < kWORDS; ++w)
+                                {
+                                    target[w] |= next[pc][w];
+                                }
+                            }
+                        }
+                        std::size_t found = 0;
+                        while (found < nbStates && !sameSet(states[found], target))
+                        {
+                            ++found;
+                        }
+                        if (found == nbStates)
+                        {
+                            if (nbStates == kMAX_STATES)
+                            {
+                                return;
+                            }
+                            states[nbStates++] = target;
+                        }
+                        mTable[state * kMAX_CLASSES + cls] = static_cast<StateT>(found);
+                    }
+                }
+                mHasDfa = true;
+            }
+
+            // Follows the epsilon transitions from pc depth first, so that threads are
+            // added in priority order.
+            template <typename Slots>
+            constexpr void addThread(Threads<Slots> &threads, std::size_t const pc, Slots &slots,
+                                     std::size_t const pos) const
+            {
+                if (threads.marks[pc] == pos + 1)
+                {
+                    return;
+                }
+                threads.marks[pc] = pos + 1;
+                auto const &instr = mInstrs[pc];
+                switch (instr.op)
+                {
+                case RegexOp::kJMP:
+                    addThread(threads, instr.x, slots, pos);
+                    break;
+                case RegexOp::kSPLIT:
+                    addThread(threads, instr.x, slots, pos);
+                    addThread(threads, instr.y, slots, pos);
+                    break;
+                case RegexOp::kSAVE:
+                    if (instr.x < slots.size())
+                    {
+                        auto const old = slots[instr.x];
+                        slots[instr.x] = pos;
+                        addThread(threads, pc + 1, slots, pos);
+                        slots[instr.x] = old;
+                    }
+                    else
+                    {
+                        addThread(threads, pc + 1, slots, pos);
+                    }
+                    break;
+                case RegexOp::kSET:
+                case RegexOp::kMATCH:
+                    threads.pcs[threads.size] = pc;
+                    threads.slots[threads.size] = slots;
+                    ++threads.size;
+                    break;
+                }
+            }
+
+            template <typename Slots, std::size_t nbCaptures>
+            constexpr static void fillGroups(std::string_view const str, Slots const &slots,
+                                             std::array<std::string_view, nbCaptures> &groups)
+            {
+                for (std::size_t i = 0; i < nbCaptures; ++i)
+                {
+                    auto const begin = slots[2 * i + 2];
+                    auto const end = slots[2 * i + 3];
+                    groups[i] = begin == std::string_view::npos || end == std::string_view::npos
+                                    ? std::string_view{}
+                                    : str.substr(begin, end - begin);
+                }
+            }
+
+            std::array<RegexInstr, kMAX_INSTRS> mInstrs{};
+            std::size_t mNbInstrs = 0;
+            std::array<ByteSet, N> mSets{};
+            std::size_t mNbSets = 0;
+            std::size_t mNbGroups = 0;
+            std::array<uint8_t, 256> mClassOf{};
+            std::size_t mNbClasses = 0;
+            std::array<StateT, kMAX_STATES * kMAX_CLASSES> mTable{};
+            std::array<bool, kMAX_STATES> mAccepting{};
+            bool mHasDfa = false;
+        };
+
+        template <std::size_t N>
+        constexpr auto regex(char const (&source)[N])
+        {
+            return Regex<N>{source};
+        }
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+        template <std::size_t N>
+        class FixedString
+        {
+        public:
+            constexpr FixedString(char const (&str)[N])
+            {
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    mData[i] = str[i];
+                }
+            }
+            char mData[N]{};
+        };
+
+        // One automaton per source, built at compile time.
+        template <FixedString source>
+        inline constexpr auto kREGEX = Regex<sizeof(source.mData)>{source.mData};
+
+        template <FixedString source, typename... Patterns>
+        constexpr auto regex(Patterns const &...patterns)
+        {
+            return kREGEX<source>(patterns...);
+        }
+#endif
+
+        template <std::size_t N, bool owned, typename... Patterns>
+        class PatternTraits<RegexPattern<N, owned, Patterns...>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple = decltype(std::tuple_cat(
+                std::declval<typename PatternTraits<Patterns>::template AppResultTuple<
+                    std::string_view>>()...));
+
+            constexpr static auto nbIdV = (PatternTraits<Patterns>::nbIdV + ... + 0);
+
+            template <typename Value, typename ContextT>
+            constexpr static bool matchPatternImpl(Value &&value,
+                                                   RegexPattern<N, owned, Patterns...> const &regexPat,
+                                                   int32_t depth, ContextT &context)
+            {
+                static_assert(std::is_convertible_v<Value const &, std::string_view>,
+                              "regex matches strings.");
+                auto const str = std::string_view{value};
+                if (!regexPat.regex().matches(str))
+                {
+                    return false;
+                }
+                if constexpr (sizeof...(Patterns) == 0)
+                {
+                    return true;
+                }
+                else
+                {
+                    auto groups = std::array<std::string_view, sizeof...(Patterns)>{};
+                    regexPat.regex().capture(str, groups);
+                    return matchGroups(groups, regexPat, depth, context,
+                                       std::index_sequence_for<Patterns...>{});
+                }
+            }
+
+            constexpr static void processIdImpl(RegexPattern<N, owned, Patterns...> const &regexPat,
+                                                int32_t depth, IdProcess idProcess)
+            {
+                return std::apply(
+                    [depth, idProcess](auto &&...patterns)
+                    { return (processId(patterns, depth, idProcess), ...); },
+                    regexPat.patterns());
+            }
+
+        private:
+            template <typename Groups, typename ContextT, std::size_t... I>
+            constexpr static bool matchGroups(Groups const &groups,
+                                              RegexPattern<N, owned, Patterns...> const &regexPat,
+                                              int32_t depth, ContextT &context,
+                                              std::index_sequence<I...>)
+            {
+                // temporaries, so that Ids own the views.
+                return (matchPattern(std::string_view{groups[I]},
+                                     std::get<I>(regexPat.patterns()), depth + 1, context) &&
+                        ...);
+            }
+        };
+    } // namespace impl
+
+    using impl::regex;
+    using impl::Regex;
+} // namespace matchit
+
+#endif // MATCHIT_REGEX_H
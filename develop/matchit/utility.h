@@ -46,7 +46,7 @@ namespace matchit
     {
     public:
       template <typename Variant,
-                typename std::enable_if<viaGetIfV<T, Variant>>::type * = nullptr>
+                typename std::enable_if<viaGetIfV<T, Variant> && !hasKindV<Variant>>::type * = nullptr>
       constexpr auto operator()(Variant const &v) const
       {
         return get_if<T>(std::addressof(v));
@@ -66,12 +66,20 @@ namespace matchit
         return static_cast<T const *>(std::addressof(d));
       }
 
-      template <typename B, typename std::enable_if<!viaGetIfV<T, B> && std::is_base_of_v<B, T>>::type * = nullptr>
+      template <typename B, typename std::enable_if<!viaGetIfV<T, B> && std::is_base_of_v<B, T> && !hasKindV<B>>::type * = nullptr>
       constexpr auto operator()(B const &b) const
           -> decltype(dynamic_cast<T const *>(std::addressof(b)))
       {
         return dynamic_cast<T const *>(std::addressof(b));
       }
+
+      // closed class hierarchies, see KindTraits.
+      template <typename B, typename std::enable_if<std::is_base_of_v<B, T> && !std::is_same_v<B, T> && hasKindV<B>>::type * = nullptr>
+      constexpr auto operator()(B const &b) const
+      {
+        static_assert(isStaticDowncastV<B, T>, "KindTraits needs T to derive from B neither virtually nor ambiguously.");
+        return KindTraits<B>::kind(b) == kindOfV<T, B> ? static_cast<T const *>(std::addressof(b)) : nullptr;
+      }
     };
 
     template <typename T>
@@ -34,11 +34,15 @@ bool operator==(Rectangle const &lhs, Rectangle const &rhs)
   return lhs.width == rhs.width && lhs.height == rhs.height;
 }
 
-template <typename T>
-auto get_if(Shape const *shape)
+// The kind tag replaces dynamic_cast, and is read once per match.
+template <>
+class matchit::KindTraits<Shape>
 {
-  return static_cast<T const *>(shape->kind == T::k ? shape : nullptr);
-}
+public:
+  constexpr static auto kind(Shape const &shape) { return shape.kind; }
+  template <typename T>
+  constexpr static auto kindOf = T::k;
+};
 
 double get_area(const Shape &shape)
 {
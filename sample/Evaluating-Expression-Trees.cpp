@@ -50,7 +50,6 @@ int eval(const Expr &ex)
   Id<Expr> e, l, r;
   return match(ex)(
       // clang-format off
-        // FIXME: Expr{5} won't match the following line.
         pattern | as<int>(i)                   = expr(i),
         pattern | asNegDs(some(e))             = [&]{ return -eval(*e); },
         pattern | asAddDs(some(l), some(r))    = [&]{ return eval(*l) + eval(*r); },
@@ -1,5 +1,6 @@
 #include "matchit.h"
 #include <iostream>
+#include <string_view>
 
 int32_t main()
 {
@@ -12,5 +13,16 @@ int32_t main()
         pattern | _     = [&] { std::cout << "don't care"; }
       // clang-format on
   );
+  std::cout << std::endl;
+
+  // string literals are compared by length first, then by content.
+  constexpr std::string_view cmd = "GET";
+  std::cout << match(cmd)(
+                   // clang-format off
+                     pattern | "GET"  = expr("read"),
+                     pattern | "PUT"  = expr("write"),
+                     pattern | _      = expr("unknown"))
+            // clang-format on
+            << std::endl;
   return 0;
 }
@@ -39,9 +39,9 @@ void Node<T>::balance()
                 app(&Node<T>::value, value), app(&Node<T>::rhs, rhs));
   };
 
-  Id<std::shared_ptr<Node<T>>> a, b, c, d;
-  Id<T> x, y, z;
-  Id<Node> self;
+  Id<std::shared_ptr<Node<T>>, ByRef> a, b, c, d;
+  Id<T, ByRef> x, y, z;
+  Id<Node, ByRef> self;
   *this = match(*this)(
       pattern | dsN(Black, some(dsN(Red, some(dsN(Red, a, x, b)), y, c)), z,
                     d) // left-left case
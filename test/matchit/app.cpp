@@ -1,5 +1,8 @@
 #include "matchit.h"
 #include <gtest/gtest.h>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 using namespace matchit;
 
 class Base
@@ -26,8 +29,135 @@ static_assert(std::is_same_v<
                   template AppResult<Base *>,
               Base &>);
 
+constexpr auto toVector = [](int32_t n)
+{ return std::vector<int32_t>(static_cast<std::size_t>(n)); };
+using VectorArm =
+    impl::PatternPair<impl::App<decltype(toVector), impl::Wildcard>, int32_t (*)()>;
+using PlainArm = impl::PatternPair<impl::Wildcard, int32_t (*)()>;
+// contexts are sized per arm, a plain arm carries none of the vector slots.
+static_assert(std::is_empty_v<impl::ArmContextT<int32_t, PlainArm>>);
+static_assert(std::is_same_v<impl::ArmContextT<int32_t, VectorArm>,
+                             impl::Context<std::vector<int32_t>>>);
+
 TEST(App, someAs)
 {
   auto const x = std::unique_ptr<Base>{new Derived};
   EXPECT_TRUE(matched(x, some(as<Derived>(_))));
 }
+
+class Shape
+{
+public:
+  explicit Shape(int32_t sides) : mSides{sides} {}
+  int32_t sides() const
+  {
+    ++calls;
+    return mSides;
+  }
+  std::vector<int32_t> corners() const
+  {
+    ++calls;
+    return std::vector<int32_t>(static_cast<std::size_t>(mSides));
+  }
+  static inline int32_t calls = 0;
+
+private:
+  int32_t mSides;
+};
+
+TEST(App, memoComputesOncePerMatch)
+{
+  Shape::calls = 0;
+  auto const sides = memo<Shape>(&Shape::sides);
+  auto const name = [&](Shape const &s)
+  {
+    return match(s)(
+        // clang-format off
+        pattern | app(sides, 3)         = expr("triangle"),
+        pattern | app(sides, 4)         = expr("square"),
+        pattern | app(sides, _ > 4)     = expr("polygon"),
+        pattern | _                     = expr("degenerate")
+        // clang-format on
+    );
+  };
+  auto const shape = Shape{4};
+  EXPECT_STREQ(name(shape), "square");
+  EXPECT_EQ(Shape::calls, 1);
+  EXPECT_STREQ(name(shape), "square");
+  EXPECT_EQ(Shape::calls, 2);
+  EXPECT_STREQ(name(Shape{1}), "degenerate");
+  EXPECT_EQ(Shape::calls, 3);
+}
+
+TEST(App, memoForgetsWhenAPatternThrows)
+{
+  Shape::calls = 0;
+  auto const sides = memo<Shape>(&Shape::sides);
+  auto const fail = [](int32_t) -> bool { throw std::runtime_error{"fail"}; };
+  auto shape = Shape{4};
+  EXPECT_THROW(match(shape)(
+                   // clang-format off
+                   pattern | app(sides, 3)          = expr(0),
+                   pattern | app(sides, meet(fail)) = expr(1)
+                   // clang-format on
+                   ),
+               std::runtime_error);
+  // same address, other sides.
+  shape = Shape{3};
+  EXPECT_EQ(match(shape)(pattern | app(sides, 3) = expr(0), pattern | _ = expr(1)), 0);
+  EXPECT_EQ(Shape::calls, 2);
+}
+
+// temporaries of different arms may share an address.
+static_assert(std::is_invocable_v<Memo<Shape, int32_t (Shape::*)() const> const &, Shape const &>);
+static_assert(!std::is_invocable_v<Memo<Shape, int32_t (Shape::*)() const> const &, Shape>);
+
+TEST(App, memoBindsIntoCachedValue)
+{
+  Shape::calls = 0;
+  auto const corners = memo<Shape>(&Shape::corners);
+  Id<std::vector<int32_t>> c;
+  auto const shape = Shape{5};
+  auto const size = [](auto const &v) { return v.size(); };
+  auto const result = match(shape)(
+      // clang-format off
+      pattern | app(corners, app(size, 3U))   = expr(std::size_t{0}),
+      pattern | app(corners, c)               = [&] { return (*c).size(); }
+      // clang-format on
+  );
+  EXPECT_EQ(result, 5U);
+  EXPECT_EQ(Shape::calls, 1);
+}
+
+TEST(App, memoKeepsBindingsOfEarlierSubjects)
+{
+  auto const corners = memo<Shape>(&Shape::corners);
+  Id<std::vector<int32_t>> a, b;
+  auto const shapes = std::pair{Shape{2}, Shape{7}};
+  match(shapes)(pattern | ds(app(corners, a), app(corners, b)) = [] {});
+  EXPECT_EQ((*a).size(), 2U);
+  EXPECT_EQ((*b).size(), 7U);
+}
+
+TEST(App, memoForgetsBetweenMatchAllCalls)
+{
+  Shape::calls = 0;
+  auto const sides = memo<Shape>(&Shape::sides);
+  auto shapes = std::vector<Shape>{Shape{2}};
+  auto results = std::vector<int32_t>(shapes.size());
+  auto const name = [&]
+  {
+    matchAll(shapes, results.begin(),
+             // clang-format off
+             pattern | app(sides, 3) = expr(3),
+             pattern | app(sides, _) = expr(0)
+             // clang-format on
+    );
+    return results[0];
+  };
+  EXPECT_EQ(name(), 0);
+  // same address, other sides.
+  shapes[0] = Shape{3};
+  EXPECT_EQ(name(), 3);
+  EXPECT_EQ(Shape::calls, 2);
+}
@@ -0,0 +1,100 @@
+#include "matchit.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#if __cplusplus > 201703L
+#include <span>
+#endif
+using namespace matchit;
+
+using Bytes = Subrange<uint8_t const *, uint8_t const *>;
+
+constexpr auto kIpv4Header = std::array<uint8_t, 6>{0x45, 0x00, 0x00, 0x54, 0xAB, 0xCD};
+
+static_assert(matched(kIpv4Header, bin(bits<4>(4), bits<4>(5), be<8>(0), be<16>(84), ooo)));
+static_assert(!matched(kIpv4Header, bin(bits<4>(6), bits<4>(_), ooo)));
+
+TEST(Bin, fields)
+{
+  Id<uint32_t> version, ihl, length, rest;
+  auto const ok = match(kIpv4Header)(
+      pattern | bin(bits<4>(version), bits<4>(ihl), be<8>(_), be<16>(length), le<16>(rest)) =
+          [&]
+      {
+        EXPECT_EQ(*version, 4U);
+        EXPECT_EQ(*ihl, 5U);
+        EXPECT_EQ(*length, 84U);
+        EXPECT_EQ(*rest, 0xCDABU);
+        return true;
+      },
+      pattern | _ = expr(false));
+  EXPECT_TRUE(ok);
+}
+
+TEST(Bin, sizeMustMatchWithoutOoo)
+{
+  EXPECT_FALSE(matched(kIpv4Header, bin(be<32>(_))));
+  EXPECT_TRUE(matched(kIpv4Header, bin(be<32>(_), ooo)));
+  EXPECT_TRUE(matched(kIpv4Header, bin(be<48>(0x45000054ABCDULL))));
+  EXPECT_FALSE(matched(std::vector<uint8_t>{0x45}, bin(be<16>(_), ooo)));
+}
+
+TEST(Bin, unalignedBitfields)
+{
+  // 3 + 10 + 3 bits: 101 0110011001 110
+  auto const bytes = std::vector<uint8_t>{0xAC, 0xCE};
+  Id<uint16_t> middle;
+  auto const value = match(bytes)(
+      pattern | bin(bits<3>(5), bits<10>(middle), bits<3>(6)) = [&] { return *middle; },
+      pattern | _ = expr(uint16_t{0}));
+  EXPECT_EQ(value, 0x199);
+}
+
+TEST(Bin, payloadIsNotCopied)
+{
+  auto const frame = std::vector<uint8_t>{0x08, 0x00, 0x00, 0x02, 'h', 'i'};
+  Id<uint16_t> size;
+  Id<Bytes> payload;
+  auto const ok = match(frame)(
+      pattern | bin(be<16>(0x0800), be<16>(size), payload.at(ooo)) =
+          [&]
+      {
+        EXPECT_EQ(*size, 2U);
+        EXPECT_EQ((*payload).size(), 2U);
+        EXPECT_EQ((*payload).begin(), frame.data() + 4);
+        return true;
+      },
+      pattern | _ = expr(false));
+  EXPECT_TRUE(ok);
+}
+
+TEST(Bin, nestedOnPayload)
+{
+  auto const frame = std::vector<uint8_t>{0x01, 0x00, 0x10, 0x20};
+  Id<Bytes> payload;
+  Id<uint32_t> inner;
+  auto const ok = match(frame)(
+      pattern | bin(be<8>(1), payload.at(ooo)) =
+          [&] { return match(*payload)(pattern | bin(le<24>(inner)) = [&] { return *inner; }); },
+      pattern | _ = expr(0U));
+  EXPECT_EQ(ok, 0x201000U);
+}
+
+TEST(Bin, stdByte)
+{
+  auto const bytes = std::array<std::byte, 2>{std::byte{0x12}, std::byte{0x34}};
+  EXPECT_TRUE(matched(bytes, bin(le<16>(0x3412))));
+  EXPECT_FALSE(matched(bytes, bin(be<16>(0x3412))));
+}
+
+#if __cplusplus > 201703L
+TEST(Bin, span)
+{
+  auto const bytes = std::array<std::byte, 3>{std::byte{0xFF}, std::byte{0x01}, std::byte{0x02}};
+  auto const span = std::span<std::byte const>{bytes};
+  EXPECT_TRUE(matched(span, bin(be<8>(0xFF), ooo)));
+  EXPECT_TRUE(matched(span.subspan(1), bin(be<16>(0x0102))));
+}
+#endif
@@ -31,3 +31,52 @@ constexpr auto eval(Value &&input)
 }
 
 static_assert(eval(std::make_tuple('/', 0, 5)) == 0);
+
+// not trivially copyable, so a run time match constructs it in place.
+class Point
+{
+public:
+  constexpr Point() = default;
+  constexpr Point(int32_t x, int32_t y) : mX{x}, mY{y} {}
+  constexpr Point(Point const &other) : mX{other.mX}, mY{other.mY} {}
+  constexpr Point &operator=(Point const &other)
+  {
+    mX = other.mX;
+    mY = other.mY;
+    return *this;
+  }
+  constexpr int32_t x() const { return mX; }
+  constexpr int32_t y() const { return mY; }
+
+private:
+  int32_t mX{};
+  int32_t mY{};
+};
+
+constexpr Point mirror(int32_t n)
+{
+  return match(n)(
+      // clang-format off
+        pattern | 0 = expr(Point{}),
+        pattern | _ = [n] { return Point{n, -n}; }
+      // clang-format on
+  );
+}
+
+static_assert(mirror(0).x() == 0);
+static_assert(mirror(3).y() == -3);
+
+#if __cplusplus > 201703L
+constexpr std::pair<int32_t, int32_t> split(int32_t n)
+{
+  return match(n)(
+      // clang-format off
+        pattern | (_ < 0) = [n] { return std::pair{-1, -n}; },
+        pattern | _       = [n] { return std::pair{1, n}; }
+      // clang-format on
+  );
+}
+
+static_assert(split(-4) == std::pair{-1, 4});
+static_assert(split(5) == std::pair{1, 5});
+#endif
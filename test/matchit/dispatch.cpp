@@ -0,0 +1,1000 @@
+#include "matchit.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+using namespace matchit;
+
+enum class Op
+{
+  kADD,
+  kSUB,
+  kMUL,
+  kHALT
+};
+
+constexpr int32_t step(Op op)
+{
+  return match(op)(
+      // clang-format off
+      pattern | Op::kADD  = expr(1),
+      pattern | Op::kSUB  = expr(2),
+      pattern | Op::kMUL  = expr(3),
+      pattern | _         = expr(0)
+      // clang-format on
+  );
+}
+
+static_assert(step(Op::kSUB) == 2);
+static_assert(step(Op::kHALT) == 0);
+
+static_assert(impl::isLiteralDispatchV<
+              char, impl::PatternPair<char, int32_t (*)()>,
+              impl::PatternPair<int32_t, int32_t (*)()>,
+              impl::PatternPair<impl::Wildcard, int32_t (*)()>>);
+static_assert(!impl::isLiteralDispatchV<
+              int32_t, impl::PatternPair<int32_t, int32_t (*)()>,
+              impl::PatternPair<impl::Or<int32_t, int32_t>, int32_t (*)()>>);
+
+TEST(LiteralDispatch, firstMatchWins)
+{
+  auto const matchFunc = [](int32_t opcode)
+  {
+    return match(opcode)(
+        // clang-format off
+        pattern | 1 = expr(10),
+        pattern | 2 = expr(20),
+        pattern | 1 = expr(30),
+        pattern | _ = expr(-1),
+        pattern | 3 = expr(40)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(matchFunc(1), 10);
+  EXPECT_EQ(matchFunc(2), 20);
+  EXPECT_EQ(matchFunc(3), -1);
+}
+
+TEST(LiteralDispatch, statement)
+{
+  int32_t hits = 0;
+  for (auto c : {'a', 'b', 'z'})
+  {
+    match(c)(
+        // clang-format off
+        pattern | 'a' = [&] { hits += 1; },
+        pattern | 'b' = [&] { hits += 10; }
+        // clang-format on
+    );
+  }
+  EXPECT_EQ(hits, 11);
+}
+
+TEST(LiteralDispatch, noMatch)
+{
+  EXPECT_THROW(match(4)(pattern | 1 = expr(true), pattern | 2 = expr(false)),
+               std::logic_error);
+}
+
+TEST(LiteralDispatch, denseSparseAndUnsorted)
+{
+  auto const dense = [](int32_t v)
+  {
+    return match(v)(
+        // clang-format off
+        pattern | -2 = expr(0),
+        pattern | -1 = expr(1),
+        pattern | 0  = expr(2),
+        pattern | 1  = expr(3),
+        pattern | _  = expr(-1)
+        // clang-format on
+    );
+  };
+  auto const sparse = [](int64_t v)
+  {
+    return match(v)(
+        // clang-format off
+        pattern | 3  = expr(0),
+        pattern | 7  = expr(1),
+        pattern | 40 = expr(2),
+        pattern | 41 = expr(3),
+        pattern | _  = expr(-1)
+        // clang-format on
+    );
+  };
+  auto const unsorted = [](uint32_t v)
+  {
+    return match(v)(
+        // clang-format off
+        pattern | 9u = expr(0),
+        pattern | 2u = expr(1),
+        pattern | 9u = expr(2),
+        pattern | 5u = expr(3),
+        pattern | _  = expr(-1)
+        // clang-format on
+    );
+  };
+  for (int32_t i = -4; i < 4; ++i)
+  {
+    EXPECT_EQ(dense(i), i >= -2 && i <= 1 ? i + 2 : -1);
+  }
+  EXPECT_EQ(sparse(3), 0);
+  EXPECT_EQ(sparse(40), 2);
+  EXPECT_EQ(sparse(41), 3);
+  EXPECT_EQ(sparse(8), -1);
+  EXPECT_EQ(sparse(-3), -1);
+  EXPECT_EQ(unsorted(9), 0);
+  EXPECT_EQ(unsorted(5), 3);
+  EXPECT_EQ(unsorted(0), -1);
+}
+
+// sorted once, equal literals keep the first arm.
+constexpr auto kUNSORTED = impl::LiteralTable<int32_t, 5>{std::array<int32_t, 5>{9, 2, 9, 5, 2}};
+static_assert(kUNSORTED.find(9) == 0);
+static_assert(kUNSORTED.find(2) == 1);
+static_assert(kUNSORTED.find(5) == 3);
+static_assert(kUNSORTED.find(3) == 5);
+// consecutive once sorted, found by their offset.
+constexpr auto kSHUFFLED = impl::LiteralTable<int32_t, 4>{std::array<int32_t, 4>{1, -1, 0, -2}};
+static_assert(kSHUFFLED.find(-2) == 3);
+static_assert(kSHUFFLED.find(1) == 0);
+static_assert(kSHUFFLED.find(2) == 4);
+static_assert(kSHUFFLED.find(-3) == 4);
+
+TEST(LiteralDispatch, matcherUnsorted)
+{
+  auto const opcode = matcher(
+      // clang-format off
+      pattern | 9u = expr(0),
+      pattern | 2u = expr(1),
+      pattern | 9u = expr(2),
+      pattern | 5u = expr(3),
+      pattern | _  = expr(-1)
+      // clang-format on
+  );
+  EXPECT_EQ(opcode(9u), 0);
+  EXPECT_EQ(opcode(2u), 1);
+  EXPECT_EQ(opcode(5u), 3);
+  EXPECT_EQ(opcode(4u), -1);
+}
+
+TEST(LiteralDispatch, keysChangeBetweenCalls)
+{
+  auto const matchFunc = [](int32_t v, int32_t key)
+  {
+    return match(v)(
+        // clang-format off
+        pattern | key = expr(1),
+        pattern | 2   = expr(2),
+        pattern | _   = expr(0)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(matchFunc(1, 1), 1);
+  EXPECT_EQ(matchFunc(1, 3), 0);
+  EXPECT_EQ(matchFunc(3, 3), 1);
+  EXPECT_EQ(matchFunc(2, 2), 1);
+  EXPECT_EQ(matchFunc(2, 1), 2);
+}
+
+struct Node : std::variant<int32_t, std::string, std::vector<int32_t>>
+{
+  using variant::variant;
+};
+
+static_assert(std::is_same_v<impl::VariantBaseT<Node const &>,
+                             std::variant<int32_t, std::string, std::vector<int32_t>>>);
+static_assert(std::is_same_v<impl::VariantBaseT<int32_t>, void>);
+
+TEST(VariantDispatch, derivedVariant)
+{
+  Id<int32_t> i;
+  Id<std::string> s;
+  auto const matchFunc = [&](Node const &node)
+  {
+    return match(node)(
+        // clang-format off
+        pattern | as<int32_t>(0)              = expr(0),
+        pattern | as<std::string>(s)          = [&] { return static_cast<int32_t>((*s).size()); },
+        pattern | as<int32_t>(i)              = [&] { return *i * 2; },
+        pattern | _                           = expr(-1)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(matchFunc(Node{0}), 0);
+  EXPECT_EQ(matchFunc(Node{21}), 42);
+  EXPECT_EQ(matchFunc(Node{std::string{"abc"}}), 3);
+  EXPECT_EQ(matchFunc(Node{std::vector<int32_t>{}}), -1);
+}
+
+TEST(VariantDispatch, noMatch)
+{
+  using V = std::variant<int32_t, char>;
+  auto const matchFunc = [](V const &v)
+  {
+    Id<char> c;
+    return match(v)(
+        // clang-format off
+        pattern | as<char>(c.at('x'))     = expr(1),
+        pattern | as<int32_t>(_ > 0)      = expr(2)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(matchFunc(V{'x'}), 1);
+  EXPECT_EQ(matchFunc(V{5}), 2);
+  EXPECT_THROW(matchFunc(V{'y'}), std::logic_error);
+  EXPECT_THROW(matchFunc(V{-5}), std::logic_error);
+}
+
+TEST(VariantDispatch, statement)
+{
+  using V = std::variant<int32_t, std::string>;
+  std::string log;
+  Id<std::string> s;
+  for (auto const &v : {V{1}, V{std::string{"two"}}})
+  {
+    match(v)(
+        // clang-format off
+        pattern | as<std::string>(s) = [&] { log += *s; },
+        pattern | as<int32_t>(_)     = [&] { log += "int"; }
+        // clang-format on
+    );
+  }
+  EXPECT_EQ(log, "inttwo");
+}
+
+static_assert(impl::isVariantArmV<std::variant<int32_t, char>, decltype(as<char>(_))>);
+static_assert(!impl::isVariantArmV<std::variant<int32_t, char>, decltype(as<bool>(_))>);
+
+constexpr int32_t command(std::string_view cmd)
+{
+  return match(cmd)(
+      // clang-format off
+      pattern | "GET"    = expr(1),
+      pattern | "GOT"    = expr(2),
+      pattern | ""       = expr(3),
+      pattern | "DELETE" = expr(4),
+      pattern | _        = expr(0)
+      // clang-format on
+  );
+}
+
+static_assert(command("GET") == 1);
+static_assert(command("GOT") == 2);
+static_assert(command("GXT") == 0);
+static_assert(command("") == 3);
+static_assert(command("DELETE") == 4);
+static_assert(command("GETS") == 0);
+
+static_assert(std::is_same_v<decltype(pattern | "abc"),
+                             impl::PatternHelper<impl::StringLiteral<4>>>);
+static_assert(impl::StringLiteral<4>{"abc"}.size() == 3);
+constexpr char kPadded[8] = "ab";
+static_assert(impl::StringLiteral<8>{kPadded}.size() == 2);
+
+TEST(StringDispatch, string)
+{
+  auto const matchFunc = [](std::string const &s)
+  {
+    return match(s)(
+        // clang-format off
+        pattern | "foo" = expr(1),
+        pattern | "bar" = expr(2),
+        pattern | "foo" = expr(3),
+        pattern | "baz" = expr(4)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(matchFunc("foo"), 1);
+  EXPECT_EQ(matchFunc("bar"), 2);
+  EXPECT_EQ(matchFunc("baz"), 4);
+  EXPECT_THROW(matchFunc("ba"), std::logic_error);
+  EXPECT_THROW(matchFunc(std::string{"ba\0r", 4}), std::logic_error);
+}
+
+TEST(StringDispatch, sameKeys)
+{
+  auto const matchFunc = [](std::string_view s)
+  {
+    return match(s)(
+        // clang-format off
+        pattern | "axc" = expr(1),
+        pattern | "abc" = expr(2),
+        pattern | "ab"  = expr(3),
+        pattern | "aac" = expr(4),
+        pattern | "abd" = expr(5),
+        pattern | ""    = expr(6),
+        pattern | _     = expr(0)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(matchFunc("axc"), 1);
+  EXPECT_EQ(matchFunc("abc"), 2);
+  EXPECT_EQ(matchFunc("ab"), 3);
+  EXPECT_EQ(matchFunc("aac"), 4);
+  EXPECT_EQ(matchFunc("abd"), 5);
+  EXPECT_EQ(matchFunc(""), 6);
+  EXPECT_EQ(matchFunc("adc"), 0);
+  EXPECT_EQ(matchFunc("a"), 0);
+}
+
+TEST(StringDispatch, charBuffers)
+{
+  char buf[16] = "foo";
+  char const constBuf[16] = "foo";
+  auto const matchFunc = [&](std::string const &s)
+  {
+    return match(s)(
+        // clang-format off
+        pattern | buf      = expr(1),
+        pattern | constBuf = expr(2),
+        pattern | _        = expr(0)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(matchFunc(std::string{"foo"}), 1);
+  // the buffer is read when matching.
+  buf[0] = 'b';
+  EXPECT_EQ(matchFunc(std::string{"foo"}), 2);
+  EXPECT_EQ(matchFunc(std::string{"boo"}), 1);
+  EXPECT_EQ(matchFunc(std::string{"foo\0", 4}), 0);
+}
+
+TEST(StringDispatch, literalsChangeBetweenCalls)
+{
+  auto const matchFunc = [](std::string_view s, char first)
+  {
+    // a new literal at the same address on each call.
+    char const key[4] = {first, 'b', 'c', '\0'};
+    return match(s)(
+        // clang-format off
+        pattern | key   = expr(1),
+        pattern | "xbc" = expr(2),
+        pattern | _     = expr(0)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(matchFunc("abc", 'a'), 1);
+  EXPECT_EQ(matchFunc("abc", 'z'), 0);
+  EXPECT_EQ(matchFunc("zbc", 'z'), 1);
+  EXPECT_EQ(matchFunc("xbc", 'a'), 2);
+  EXPECT_EQ(matchFunc("xbc", 'x'), 1);
+}
+
+// equal literals keep the first arm, a miss probes to an empty slot.
+constexpr auto kVERBS = impl::StringTable<4>{
+    std::array<std::string_view, 4>{"GET", "PUT", "GET", ""}};
+static_assert(kVERBS.find("GET") == 0);
+static_assert(kVERBS.find("PUT") == 1);
+static_assert(kVERBS.find("") == 3);
+static_assert(kVERBS.find("POST") == 4);
+
+TEST(StringDispatch, matcherTable)
+{
+  auto const verb = matcher(
+      // clang-format off
+      pattern | "GET"     = expr(1),
+      pattern | "PUT"     = expr(2),
+      pattern | "POST"    = expr(3),
+      pattern | "GET"     = expr(4),
+      pattern | "DELETE"  = expr(5),
+      pattern | "PATCH"   = expr(6),
+      pattern | "HEAD"    = expr(7),
+      pattern | "OPTIONS" = expr(8),
+      pattern | _         = expr(0)
+      // clang-format on
+  );
+  EXPECT_EQ(verb(std::string_view{"GET"}), 1);
+  EXPECT_EQ(verb(std::string{"POST"}), 3);
+  EXPECT_EQ(verb(std::string_view{"OPTIONS"}), 8);
+  EXPECT_EQ(verb(std::string_view{"HEAD"}), 7);
+  EXPECT_EQ(verb(std::string_view{"GETS"}), 0);
+  EXPECT_EQ(verb(std::string_view{""}), 0);
+}
+
+TEST(StringDispatch, pointerKeepsIdentity)
+{
+  constexpr auto s = "bar";
+  auto const matchFunc = [](char const *str)
+  {
+    return match(str)(pattern | "bar" = expr(true), pattern | _ = expr(false));
+  };
+  std::string const copy = s;
+  EXPECT_FALSE(matchFunc(copy.c_str()));
+}
+
+TEST(DsDispatch, firstMatchAndBindings)
+{
+  auto const matchFunc = [](std::tuple<char, int32_t, int32_t> const &input)
+  {
+    Id<int32_t> i;
+    Id<int32_t> j;
+    return match(input)(
+        // clang-format off
+        pattern | ds('/', 1, 1)      = expr(1),
+        pattern | ds('/', 0, _)      = expr(0),
+        pattern | ds('*', i, j)      = [&] { return *i * *j; },
+        pattern | ds('+', i, j)      = [&] { return *i + *j; },
+        pattern | ds(_, i, i)        = [&] { return -*i; },
+        pattern | _                  = expr(-1)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(matchFunc(std::make_tuple('/', 1, 1)), 1);
+  EXPECT_EQ(matchFunc(std::make_tuple('/', 0, 7)), 0);
+  EXPECT_EQ(matchFunc(std::make_tuple('*', 3, 4)), 12);
+  EXPECT_EQ(matchFunc(std::make_tuple('+', 3, 4)), 7);
+  EXPECT_EQ(matchFunc(std::make_tuple('-', 3, 3)), -3);
+  EXPECT_EQ(matchFunc(std::make_tuple('/', 2, 2)), -2);
+  EXPECT_EQ(matchFunc(std::make_tuple('-', 3, 4)), -1);
+}
+
+TEST(DsDispatch, literalColumnsAreTestedFirst)
+{
+  int32_t calls = 0;
+  auto const counted = meet(
+      [&calls](int32_t)
+      {
+        ++calls;
+        return true;
+      });
+  auto const matchFunc = [&](int32_t a, char b)
+  {
+    return match(a, b)(
+        // clang-format off
+        pattern | ds(counted, 'x') = expr(1),
+        pattern | ds(counted, 'y') = expr(2),
+        pattern | ds(_, 'z')       = expr(3)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(matchFunc(0, 'z'), 3);
+  EXPECT_EQ(calls, 0);
+  EXPECT_EQ(matchFunc(0, 'y'), 2);
+  EXPECT_EQ(calls, 1);
+}
+
+class TrackedColumn
+{
+public:
+  int32_t mValue;
+  static inline int32_t compares = 0;
+  friend bool operator==(int32_t lhs, TrackedColumn const &rhs)
+  {
+    ++compares;
+    return lhs == rhs.mValue;
+  }
+};
+
+TEST(DsDispatch, columnsAreTestedLazilyInArmOrder)
+{
+  auto const matchFunc = [](TrackedColumn const &t, int32_t i)
+  {
+    return match(t, i)(
+        // clang-format off
+        pattern | ds(1, 1) = expr(1),
+        pattern | ds(2, 2) = expr(2),
+        pattern | ds(3, _) = expr(3),
+        pattern | _        = expr(0)
+        // clang-format on
+    );
+  };
+  TrackedColumn::compares = 0;
+  EXPECT_EQ(matchFunc(TrackedColumn{1}, 1), 1);
+  // the first arm, tested before its full match, the later arms are not looked at.
+  EXPECT_EQ(TrackedColumn::compares, 2);
+  TrackedColumn::compares = 0;
+  EXPECT_EQ(matchFunc(TrackedColumn{3}, 1), 3);
+  // three arms tested, then the full match of the third.
+  EXPECT_EQ(TrackedColumn::compares, 4);
+}
+
+TEST(DsDispatch, matcherTableNarrowsColumnsFirst)
+{
+  auto const matchFunc = matcher(
+      // clang-format off
+      pattern | ds(1, 1) = expr(1),
+      pattern | ds(2, 2) = expr(2),
+      pattern | ds(3, _) = expr(3),
+      pattern | _        = expr(0)
+      // clang-format on
+  );
+  TrackedColumn::compares = 0;
+  EXPECT_EQ(matchFunc(std::make_tuple(TrackedColumn{3}, 1)), 3);
+  // the int column leaves the first and the third arm, the second is never compared.
+  EXPECT_EQ(TrackedColumn::compares, 3);
+}
+
+TEST(DsDispatch, wildcardArmsKeepArmOrder)
+{
+  auto const matchFunc = matcher(
+      // clang-format off
+      pattern | ds(Op::kADD, 0)   = expr(1),
+      pattern | ds(_, 0)          = expr(2),
+      pattern | ds(Op::kSUB, 0)   = expr(3),
+      pattern | ds(Op::kSUB, _)   = expr(4),
+      pattern | _                 = expr(0)
+      // clang-format on
+  );
+  EXPECT_EQ(matchFunc(std::make_tuple(Op::kADD, 0)), 1);
+  EXPECT_EQ(matchFunc(std::make_tuple(Op::kSUB, 0)), 2);
+  EXPECT_EQ(matchFunc(std::make_tuple(Op::kMUL, 0)), 2);
+  EXPECT_EQ(matchFunc(std::make_tuple(Op::kSUB, 5)), 4);
+  EXPECT_EQ(matchFunc(std::make_tuple(Op::kADD, 5)), 0);
+}
+
+constexpr int32_t opcode(std::tuple<Op, int32_t> const &instr)
+{
+  return match(instr)(
+      // clang-format off
+      pattern | ds(Op::kADD, 1) = expr(1),
+      pattern | ds(Op::kMUL, _) = expr(2),
+      pattern | ds(Op::kSUB, 1) = expr(3),
+      pattern | _               = expr(0)
+      // clang-format on
+  );
+}
+
+static_assert(opcode(std::make_tuple(Op::kSUB, 1)) == 3);
+static_assert(opcode(std::make_tuple(Op::kMUL, 7)) == 2);
+static_assert(opcode(std::make_tuple(Op::kADD, 2)) == 0);
+
+TEST(DsDispatch, matchedColumnDecidesLaterLiterals)
+{
+  auto const matchFunc = [](int32_t a, int32_t b)
+  {
+    return match(a, b)(
+        // clang-format off
+        pattern | ds(1, 2)            = expr(1),
+        pattern | ds(1, _)            = expr(2),
+        pattern | ds(2, 3)            = expr(3),
+        pattern | ds(int64_t{2}, _)   = expr(4),
+        pattern | _                   = expr(0)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(matchFunc(1, 2), 1);
+  EXPECT_EQ(matchFunc(1, 5), 2);
+  EXPECT_EQ(matchFunc(2, 3), 3);
+  EXPECT_EQ(matchFunc(2, 4), 4);
+  EXPECT_EQ(matchFunc(3, 3), 0);
+}
+
+constexpr int32_t acidity(int32_t ph)
+{
+  return match(ph)(
+      // clang-format off
+      pattern | (0 <= _ && _ <= 6 ) = expr(-1),
+      pattern | (7                ) = expr(0),
+      pattern | (8 <= _ && _ <= 14) = expr(1),
+      pattern | _                   = expr(2)
+      // clang-format on
+  );
+}
+
+static_assert(acidity(0) == -1);
+static_assert(acidity(7) == 0);
+static_assert(acidity(14) == 1);
+static_assert(acidity(15) == 2);
+static_assert(acidity(-1) == 2);
+
+static_assert(impl::isIntervalDispatchV<
+              double, impl::PatternPair<decltype(_ > 0 && 1.5 >= _), int32_t (*)()>,
+              impl::PatternPair<int32_t, int32_t (*)()>>);
+
+TEST(IntervalDispatch, halfOpenBuckets)
+{
+  auto const bucket = [](double value)
+  {
+    return match(value)(
+        // clang-format off
+        pattern | (0.0 <= _ && _ < 1.0) = expr(0),
+        pattern | (_ < 2.0 && 1.0 <= _) = expr(1),
+        pattern | (2.0 < _ && _ <= 3.0) = expr(2),
+        pattern | _                     = expr(-1)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(bucket(0.0), 0);
+  EXPECT_EQ(bucket(0.999), 0);
+  EXPECT_EQ(bucket(1.0), 1);
+  EXPECT_EQ(bucket(2.0), -1);
+  EXPECT_EQ(bucket(3.0), 2);
+  EXPECT_EQ(bucket(3.5), -1);
+  EXPECT_EQ(bucket(-0.5), -1);
+}
+
+TEST(IntervalDispatch, overlappingIntervalsFirstMatchWins)
+{
+  auto const width = [](uint64_t value)
+  {
+    return match(value)(
+        // clang-format off
+        pattern | (0U <= _ && _ <= 0xffU)       = expr(8),
+        pattern | (0U <= _ && _ <= 0xffffU)     = expr(16),
+        pattern | (0U <= _ && _ <= 0xffffffffU) = expr(32),
+        pattern | _                             = expr(64)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(width(0xfa), 8);
+  EXPECT_EQ(width(0xfade), 16);
+  EXPECT_EQ(width(0xfacade), 32);
+  EXPECT_EQ(width(0xfacadefacadeU), 64);
+}
+
+TEST(IntervalDispatch, boundsChangeBetweenCalls)
+{
+  auto const matchFunc = [](int32_t v, int32_t bound)
+  {
+    return match(v)(
+        // clang-format off
+        pattern | (0 <= _ && _ < bound) = expr(0),
+        pattern | (100 <= _)            = expr(1),
+        pattern | _                     = expr(-1)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(matchFunc(5, 10), 0);
+  EXPECT_EQ(matchFunc(50, 10), -1);
+  EXPECT_EQ(matchFunc(50, 60), 0);
+  // overlapping with the second arm, the first one still wins.
+  EXPECT_EQ(matchFunc(150, 200), 0);
+  EXPECT_EQ(matchFunc(150, 10), 1);
+}
+
+static_assert(impl::isIntervalDispatchV<
+              int32_t, impl::PatternPair<decltype(_ < 0), int32_t (*)()>,
+              impl::PatternPair<decltype(0 <= _ && _ < 10), int32_t (*)()>>);
+
+TEST(IntervalDispatch, manyBuckets)
+{
+  auto const bucket = [](int32_t value)
+  {
+    return match(value)(
+        // clang-format off
+        pattern | (_ < 0)              = expr(-1),
+        pattern | (0   <= _ && _ < 10) = expr(0),
+        pattern | (10  <= _ && _ < 20) = expr(1),
+        pattern | (20  <= _ && _ < 40) = expr(2),
+        pattern | (40  <= _ && _ < 80) = expr(3),
+        pattern | 80                   = expr(4),
+        pattern | (80  <  _ && _ < 160)= expr(5),
+        pattern | _                    = expr(6)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(bucket(-5), -1);
+  EXPECT_EQ(bucket(0), 0);
+  EXPECT_EQ(bucket(19), 1);
+  EXPECT_EQ(bucket(20), 2);
+  EXPECT_EQ(bucket(79), 3);
+  EXPECT_EQ(bucket(80), 4);
+  EXPECT_EQ(bucket(81), 5);
+  EXPECT_EQ(bucket(160), 6);
+}
+
+TEST(IntervalDispatch, unorderedDisjointIntervals)
+{
+  auto const bucket = [](int32_t value)
+  {
+    return match(value)(
+        // clang-format off
+        pattern | (40 <= _ && _ < 80) = expr(3),
+        pattern | (_ < 0)             = expr(-1),
+        pattern | (10 <= _ && _ < 20) = expr(1),
+        pattern | 25                  = expr(2),
+        pattern | (0  <= _ && _ < 10) = expr(0),
+        pattern | _                   = expr(4)
+        // clang-format on
+    );
+  };
+  // sorted by their lower bounds, the arms stay where they were written.
+  constexpr auto table = impl::IntervalTable<int32_t, 3>{std::array<impl::KeyInterval<int32_t>, 3>{
+      {{20, 29, true, true}, {0, 9, true, true}, {10, 19, true, true}}}};
+  static_assert(table.find(5) == 1);
+  static_assert(table.find(25) == 0);
+  static_assert(table.find(30) == 3);
+  EXPECT_EQ(bucket(-5), -1);
+  EXPECT_EQ(bucket(0), 0);
+  EXPECT_EQ(bucket(19), 1);
+  EXPECT_EQ(bucket(20), 4);
+  EXPECT_EQ(bucket(25), 2);
+  EXPECT_EQ(bucket(79), 3);
+  EXPECT_EQ(bucket(80), 4);
+}
+
+// a matcher builds the table of its arms once, unless a bound refers to an
+// lvalue.
+inline int32_t gLimit = 0;
+static_assert(std::is_same_v<impl::SiteValueT<decltype(_ < 0), decltype(0 <= _ && _ < 10),
+                                              int32_t, impl::Wildcard>,
+                             int32_t>);
+static_assert(std::is_void_v<impl::SiteValueT<decltype(_ < 0), decltype(0 <= _ && _ < gLimit)>>);
+
+TEST(IntervalDispatch, matcherTable)
+{
+  auto limit = 10;
+  auto const bucket = matcher(
+      // clang-format off
+      pattern | (_ < 0)               = expr(-1),
+      pattern | (0 <= _ && _ < 10)    = expr(0),
+      pattern | (10 <= _ && _ < 20)   = expr(1),
+      pattern | _                     = expr(2)
+      // clang-format on
+  );
+  auto const below = matcher(
+      // clang-format off
+      pattern | (0 <= _ && _ < limit) = expr(0),
+      pattern | (100 <= _)            = expr(1),
+      pattern | _                     = expr(-1)
+      // clang-format on
+  );
+  EXPECT_EQ(bucket(-3), -1);
+  EXPECT_EQ(bucket(10), 1);
+  EXPECT_EQ(bucket(int64_t{19}), 1);
+  EXPECT_EQ(bucket(25), 2);
+  EXPECT_EQ(below(50), -1);
+  limit = 60;
+  EXPECT_EQ(below(50), 0);
+}
+
+enum class MsgKind
+{
+  kPING,
+  kDATA,
+  kCLOSE
+};
+
+class Msg
+{
+public:
+  explicit Msg(MsgKind kind) : mKind{kind} {}
+  virtual ~Msg() = default;
+  virtual MsgKind kind() const
+  {
+    ++kindCalls;
+    return mKind;
+  }
+  static inline int32_t kindCalls = 0;
+
+private:
+  MsgKind mKind;
+};
+
+class Ping : public Msg
+{
+public:
+  constexpr static auto k = MsgKind::kPING;
+  Ping() : Msg{k} {}
+};
+
+class Data : public Msg
+{
+public:
+  constexpr static auto k = MsgKind::kDATA;
+  explicit Data(int32_t size) : Msg{k}, size{size} {}
+  int32_t size;
+};
+
+class Close : public Msg
+{
+public:
+  constexpr static auto k = MsgKind::kCLOSE;
+  Close() : Msg{k} {}
+};
+
+template <>
+class matchit::KindTraits<Msg>
+{
+public:
+  static auto kind(Msg const &msg) { return msg.kind(); }
+  template <typename T>
+  constexpr static auto kindOf = T::k;
+};
+
+static_assert(impl::hasKindV<Msg const &>);
+static_assert(!impl::hasKindV<Ping>);
+
+class VirtualPing : public virtual Msg
+{
+};
+
+static_assert(impl::isStaticDowncastV<Msg, Ping>);
+static_assert(!impl::isStaticDowncastV<Msg, VirtualPing>);
+
+int32_t handle(Msg const &msg)
+{
+  Id<int32_t> size;
+  return match(msg)(
+      // clang-format off
+      pattern | as<Ping>(_)                                 = expr(0),
+      pattern | as<Data>(app(&Data::size, and_(_ > 8, size))) = [&] { return *size; },
+      pattern | as<Data>(_)                                 = expr(-1),
+      pattern | _                                           = expr(-2)
+      // clang-format on
+  );
+}
+
+TEST(KindDispatch, tagIsReadOnce)
+{
+  Msg::kindCalls = 0;
+  EXPECT_EQ(handle(Ping{}), 0);
+  EXPECT_EQ(handle(Data{16}), 16);
+  EXPECT_EQ(handle(Data{4}), -1);
+  EXPECT_EQ(handle(Close{}), -2);
+  EXPECT_EQ(Msg::kindCalls, 4);
+}
+
+static_assert(impl::kindCasesV<Msg, impl::PatternPair<decltype(as<Data>(_)), int32_t (*)()>,
+                               impl::PatternPair<decltype(as<Ping>(_)), int32_t (*)()>,
+                               impl::PatternPair<decltype(as<Data>(_)), int32_t (*)()>>
+                  .mSize == 2);
+
+int32_t handleWithoutWildcard(Msg const &msg)
+{
+  return match(msg)(
+      // clang-format off
+      pattern | as<Data>(app(&Data::size, _ > 8)) = expr(1),
+      pattern | as<Ping>(_)                       = expr(2),
+      pattern | as<Data>(_)                       = expr(3)
+      // clang-format on
+  );
+}
+
+TEST(KindDispatch, armsOfTheTagInOrder)
+{
+  EXPECT_EQ(handleWithoutWildcard(Data{16}), 1);
+  EXPECT_EQ(handleWithoutWildcard(Ping{}), 2);
+  EXPECT_EQ(handleWithoutWildcard(Data{4}), 3);
+  EXPECT_THROW(handleWithoutWildcard(Close{}), std::logic_error);
+}
+
+TEST(KindDispatch, nestedAs)
+{
+  Msg::kindCalls = 0;
+  Data const data{3};
+  Msg const &msg = data;
+  auto const matched = match(std::make_tuple(1, std::cref(msg)))(
+      pattern | ds(1, as<Ping>(_)) = expr(false),
+      pattern | ds(1, as<Data>(_)) = expr(true),
+      pattern | _ = expr(false));
+  EXPECT_TRUE(matched);
+  EXPECT_EQ(Msg::kindCalls, 2);
+}
+
+class Event
+{
+public:
+  virtual ~Event() = default;
+};
+
+class Click final : public Event
+{
+public:
+  int32_t x = 1;
+};
+
+class Key final : public Event
+{
+public:
+  char key = 'k';
+};
+
+class Scroll : public Event
+{
+};
+
+class SmoothScroll : public Scroll
+{
+};
+
+using ClickArm = impl::PatternPair<decltype(as<Click>(_)), int32_t (*)()>;
+using KeyArm = impl::PatternPair<decltype(as<Key>(_)), int32_t (*)()>;
+using ScrollArm = impl::PatternPair<decltype(as<Scroll>(_)), int32_t (*)()>;
+using SmoothScrollArm = impl::PatternPair<decltype(as<SmoothScroll>(_)), int32_t (*)()>;
+using WildcardArm = impl::PatternPair<impl::Wildcard, int32_t (*)()>;
+static_assert(impl::areDisjointArmsV<Event, ClickArm, KeyArm, ScrollArm, WildcardArm>);
+static_assert(!impl::areDisjointArmsV<Event, ClickArm, ClickArm>);
+static_assert(!impl::areDisjointArmsV<Event, ScrollArm, SmoothScrollArm>);
+static_assert(!impl::areDisjointArmsV<Event, ClickArm, impl::PatternPair<int32_t, int32_t (*)()>>);
+
+int32_t route(Event const &event, AdaptiveOrder &order)
+{
+  Id<char> key;
+  return match(event).adaptive(order)(
+      // clang-format off
+      pattern | as<Click>(_)                   = expr(1),
+      pattern | as<Key>(app(&Key::key, key))   = [&] { return int32_t{*key}; },
+      pattern | as<Scroll>(_)                  = expr(3),
+      pattern | _                              = expr(0)
+      // clang-format on
+  );
+}
+
+TEST(AdaptiveOrder, hotArmMovesFirst)
+{
+  AdaptiveOrder order{8};
+  EXPECT_EQ(AdaptiveOrder::armAt(order.order(), 0), 0U);
+  Key const key{};
+  for (auto i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(route(key, order), 'k');
+  }
+  EXPECT_EQ(AdaptiveOrder::armAt(order.order(), 0), 1U);
+  EXPECT_EQ(AdaptiveOrder::armAt(order.order(), 1), 0U);
+  EXPECT_EQ(AdaptiveOrder::armAt(order.order(), 2), 2U);
+}
+
+TEST(AdaptiveOrder, resultsDoNotDependOnOrder)
+{
+  AdaptiveOrder order{2};
+  Click const click{};
+  Key const key{};
+  SmoothScroll const scroll{};
+  class Other : public Event
+  {
+  };
+  Other const other{};
+  for (auto i = 0; i < 10; ++i)
+  {
+    EXPECT_EQ(route(key, order), 'k');
+    EXPECT_EQ(route(scroll, order), 3);
+    EXPECT_EQ(route(scroll, order), 3);
+    EXPECT_EQ(route(other, order), 0);
+    EXPECT_EQ(route(click, order), 1);
+  }
+}
+
+TEST(AdaptiveOrder, tryMatchMissIsEmpty)
+{
+  AdaptiveOrder order{2};
+  auto const route = [&order](Event const &event)
+  {
+    return tryMatch(event).adaptive(order)(
+        // clang-format off
+        pattern | as<Click>(_) = expr(1),
+        pattern | as<Key>(_)   = expr(2)
+        // clang-format on
+    );
+  };
+  EXPECT_EQ(route(Key{}), std::make_optional(2));
+  EXPECT_EQ(route(Click{}), std::make_optional(1));
+  EXPECT_FALSE(route(Scroll{}).has_value());
+}
+
+constexpr int32_t hinted(int32_t i)
+{
+  return match(i)(
+      // clang-format off
+      pattern.likely | 0                  = expr(0),
+      pattern        | (1 <= _ && _ < 9)  = expr(1),
+      pattern.cold   | _                  = expr(-1)
+      // clang-format on
+  );
+}
+
+static_assert(hinted(0) == 0);
+static_assert(hinted(5) == 1);
+static_assert(hinted(42) == -1);
+static_assert(decltype(pattern.likely | 1 = expr(1))::kHINT == impl::Hint::kLIKELY);
+static_assert(decltype(pattern.cold | _ | when(expr(true)) = expr(1))::kHINT ==
+              impl::Hint::kCOLD);
+static_assert(decltype(pattern | _ = expr(1))::kHINT == impl::Hint::kNONE);
+
+TEST(Hint, coldHandlers)
+{
+  int32_t errors = 0;
+  auto const m = matcher(
+      // clang-format off
+      pattern.likely | (_ % 2 == 0)   = [] { return "even"; },
+      pattern.cold   | (_ < 0)        = [&] { ++errors; return "negative"; },
+      pattern        | _              = [] { return "odd"; }
+      // clang-format on
+  );
+  EXPECT_STREQ(m(2), "even");
+  EXPECT_STREQ(m(-3), "negative");
+  EXPECT_STREQ(m(3), "odd");
+  EXPECT_EQ(errors, 1);
+}
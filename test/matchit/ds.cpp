@@ -1,7 +1,11 @@
 #include "matchit.h"
 #include <gtest/gtest.h>
+#include <forward_list>
+#include <iterator>
 #include <list>
+#include <sstream>
 #include <utility>
+#include <vector>
 
 using namespace matchit;
 
@@ -101,6 +105,25 @@ TEST(Ds, vecOooBinder1)
   EXPECT_TRUE(matched);
 }
 
+TEST(Ds, listOooBinder)
+{
+  auto const list = std::list<int32_t>{1, 2, 3, 4, 5};
+  Id<int32_t> first, last;
+  Id<SubrangeT<decltype(list)>> middle;
+  auto const matched = match(list)(
+      pattern | ds(first, middle.at(ooo), last) =
+          [&]
+      {
+        EXPECT_EQ(*first, 1);
+        EXPECT_EQ(*last, 5);
+        expectRange(*middle, std::list<int32_t>{2, 3, 4});
+        return true;
+      },
+      pattern | _ = expr(false));
+  EXPECT_TRUE(matched);
+  EXPECT_FALSE(impl::matched(list, ds(1, ooo, 4)));
+}
+
 TEST(Ds, vecOooBinder2)
 {
   Id<SubrangeT<std::vector<int32_t>>> subrange;
@@ -308,4 +331,209 @@ TEST(Ds, mapOooAtBinder)
                                              auto const expected = {std::make_pair(456, "b"), std::make_pair(789, "c")};
                                              expectRange(*subrange, expected);
                                            });
-}
\ No newline at end of file
+}
+static_assert(impl::isStreamingV<std::forward_list<int32_t> const &>);
+static_assert(!impl::isStreamingV<std::list<int32_t> const &>);
+static_assert(!impl::isStreamingV<std::vector<int32_t> const &>);
+static_assert(std::is_same_v<impl::ContiguousElemT<std::vector<uint8_t> const &>, uint8_t>);
+static_assert(std::is_void_v<impl::ContiguousElemT<std::vector<bool>>>);
+
+TEST(Ds, forwardListWithoutSize)
+{
+  auto const list = std::forward_list<int32_t>{1, 2, 3, 4, 5};
+  EXPECT_TRUE(matched(list, ds(1, 2, 3, 4, 5)));
+  EXPECT_FALSE(matched(list, ds(1, 2, 3, 4)));
+  EXPECT_FALSE(matched(list, ds(1, 2, 3, 4, 5, 6)));
+  EXPECT_TRUE(matched(list, ds(1, ooo, 4, 5)));
+  EXPECT_FALSE(matched(list, ds(1, 2, 3, 4, ooo, 4, 5)));
+  Id<int32_t> last;
+  Id<SubrangeT<decltype(list)>> middle;
+  auto const ok = match(list)(
+      pattern | ds(1, middle.at(ooo), last) =
+          [&]
+      {
+        EXPECT_EQ(*last, 5);
+        EXPECT_EQ((*middle).size(), 3U);
+        expectRange(*middle, std::list<int32_t>{2, 3, 4});
+        return true;
+      },
+      pattern | _ = expr(false));
+  EXPECT_TRUE(ok);
+}
+
+struct IntStream
+{
+  std::istream &in;
+  auto begin() const { return std::istream_iterator<int32_t>{in}; }
+  auto end() const { return std::istream_iterator<int32_t>{}; }
+};
+
+static_assert(impl::isStreamingV<IntStream const &>);
+
+TEST(Ds, inputRange)
+{
+  std::istringstream in{"1 2 3 4 5"};
+  Id<int32_t> second, last;
+  auto const ok = match(IntStream{in})(
+      pattern | ds(1, second, ooo, 4, last) =
+          [&]
+      {
+        EXPECT_EQ(*second, 2);
+        EXPECT_EQ(*last, 5);
+        return true;
+      },
+      pattern | _ = expr(false));
+  EXPECT_TRUE(ok);
+
+  std::istringstream shortIn{"1 2"};
+  EXPECT_FALSE(matched(IntStream{shortIn}, ds(1, ooo, 1, 2)));
+  std::istringstream prefixIn{"7 8 9"};
+  EXPECT_TRUE(matched(IntStream{prefixIn}, ds(7, ooo)));
+  EXPECT_EQ(*std::istream_iterator<int32_t>{prefixIn}, 9);
+}
+
+TEST(Ds, inputRangeAcrossArms)
+{
+  auto const pick = [](std::string const &text)
+  {
+    std::istringstream in{text};
+    Id<int32_t> x;
+    return match(IntStream{in})(
+        // clang-format off
+        pattern | ds(1, 2, 3)   = expr(0),
+        pattern | ds(1, 9, 3)   = expr(1),
+        pattern | ds(1, ooo, x) = [&] { return *x; },
+        pattern | _             = expr(-1)
+        // clang-format on
+    );
+  };
+  // every arm reads the stream from its start.
+  EXPECT_EQ(pick("1 9 3"), 1);
+  EXPECT_EQ(pick("1 2 3"), 0);
+  EXPECT_EQ(pick("1 5 6 7"), 7);
+  EXPECT_EQ(pick("2 3"), -1);
+
+  std::istringstream in{"1 2 3 4 5"};
+  auto const prefix = match(IntStream{in})(
+      // clang-format off
+      pattern | ds(1, 2)   = expr(2),
+      pattern | ds(1, ooo) = expr(1),
+      pattern | _          = expr(0)
+      // clang-format on
+  );
+  EXPECT_EQ(prefix, 1);
+}
+
+TEST(Ds, inputRangeStreamsOoo)
+{
+  auto const pick = [](std::string const &text)
+  {
+    std::istringstream in{text};
+    Id<int32_t> x;
+    Id<int32_t> y;
+    return match(IntStream{in})(
+        // clang-format off
+        pattern | ds(1, 2, 3)        = expr(0),
+        pattern | ds(x, ooo, 8, 9)   = [&] { return *x; },
+        pattern | ds(ooo, y, 9)      = [&] { return *y; },
+        pattern | _                  = expr(-1)
+        // clang-format on
+    );
+  };
+  std::string text;
+  for (int32_t i = 0; i < 10'000; ++i)
+  {
+    text += "5 ";
+  }
+  // the ooo span is read once, only the first element and the last two are kept.
+  EXPECT_EQ(pick("4 " + text + "8 9"), 4);
+  EXPECT_EQ(pick(text + "7 9"), 7);
+  EXPECT_EQ(pick("1 2 3"), 0);
+  EXPECT_EQ(pick("9"), -1);
+}
+
+struct ZeroTerminated
+{
+  struct Sentinel
+  {
+  };
+  struct Iterator
+  {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = int32_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = int32_t const *;
+    using reference = int32_t const &;
+    int32_t const *ptr;
+    reference operator*() const { return *ptr; }
+    Iterator &operator++()
+    {
+      ++ptr;
+      return *this;
+    }
+    bool operator==(Sentinel) const { return *ptr == 0; }
+    bool operator!=(Sentinel) const { return *ptr != 0; }
+  };
+  int32_t const *data;
+  Iterator begin() const { return {data}; }
+  Sentinel end() const { return {}; }
+};
+
+TEST(Ds, sentinelRange)
+{
+  constexpr int32_t data[] = {3, 1, 4, 1, 5, 0};
+  auto const range = ZeroTerminated{data};
+  EXPECT_TRUE(matched(range, ds(3, 1, 4, 1, 5)));
+  EXPECT_TRUE(matched(range, ds(3, ooo, 1, 5)));
+  EXPECT_FALSE(matched(range, ds(ooo, 4, 5)));
+  EXPECT_FALSE(matched(range, ds(3, 1, 4)));
+}
+
+static_assert(matched(std::array<uint8_t, 4>{0x7f, 'E', 'L', 'F'}, ds(0x7f, 'E', ooo, 'F')));
+
+TEST(Ds, literalRuns)
+{
+  auto const elf = std::vector<uint8_t>{0x7f, 'E', 'L', 'F', 2, 1, 1, 0};
+  EXPECT_TRUE(matched(elf, ds(0x7f, 'E', 'L', 'F', ooo)));
+  EXPECT_FALSE(matched(elf, ds(0x7f, 'E', 'L', 'G', ooo)));
+  EXPECT_TRUE(matched(elf, ds(ooo, 1, 1, 0)));
+  EXPECT_FALSE(matched(elf, ds(ooo, 1, 2, 0)));
+  EXPECT_TRUE(matched(elf, ds(0x7f, _, 'L', 'F', 2, 1, 1, 0)));
+  EXPECT_FALSE(matched(elf, ds(0x7f, _, 'L', 'F', 2, 1, 1, 1)));
+
+  Id<uint8_t> cls;
+  Id<SubrangeT<decltype(elf)>> rest;
+  auto const ok = match(elf)(
+      pattern | ds(0x7f, 'E', 'L', 'F', cls, rest.at(ooo), 0) =
+          [&]
+      {
+        EXPECT_EQ(*cls, 2);
+        EXPECT_EQ((*rest).size(), 2U);
+        return true;
+      },
+      pattern | _ = expr(false));
+  EXPECT_TRUE(ok);
+}
+
+TEST(Ds, literalRunsOnArray)
+{
+  auto const header = std::array<uint8_t, 4>{0x89, 'P', 'N', 'G'};
+  EXPECT_TRUE(matched(header, ds(0x89, 'P', 'N', 'G')));
+  EXPECT_FALSE(matched(header, ds(0x89, 'P', 'N', 'J')));
+  EXPECT_TRUE(matched(header, ds(0x89, ooo, 'G')));
+  EXPECT_FALSE(matched(header, ds(0x88, ooo, 'G')));
+}
+
+TEST(Ds, literalsOutOfElementRange)
+{
+  auto const bytes = std::vector<uint8_t>{44, 255};
+  // 300 converts to 44 and -1 to 255, yet neither compares equal.
+  EXPECT_FALSE(matched(bytes, ds(300, ooo)));
+  EXPECT_FALSE(matched(bytes, ds(ooo, -1)));
+  EXPECT_FALSE(matched(bytes, ds(44, static_cast<char>(-1))));
+  EXPECT_TRUE(matched(bytes, ds(44, 255)));
+  auto const words = std::vector<uint32_t>{0xFFFFFFFFU, 7, 8};
+  EXPECT_TRUE(matched(words, ds(0xFFFFFFFFU, 7U, 8U)));
+  EXPECT_TRUE(matched(words, ds(0xFFFFFFFFU, ooo, 8U)));
+  EXPECT_FALSE(matched(words, ds(int64_t{-1}, ooo)));
+}
@@ -1,5 +1,7 @@
 #include "matchit.h"
 #include <gtest/gtest.h>
+#include <functional>
+#include <type_traits>
 using namespace matchit;
 
 TEST(Expr, nullary)
@@ -28,3 +30,46 @@ TEST(Expr, Unary)
   EXPECT_EQ((_ || false)(true), true);
   EXPECT_EQ((_ && false)(true), false);
 }
+
+class CopyCounted
+{
+public:
+  CopyCounted() = default;
+  CopyCounted(CopyCounted const &) { ++copies; }
+  CopyCounted(CopyCounted &&) = default;
+  CopyCounted &operator=(CopyCounted const &) = default;
+  CopyCounted &operator=(CopyCounted &&) = default;
+  static inline int32_t copies = 0;
+};
+
+TEST(Expr, lvaluesAreNotCopied)
+{
+  CopyCounted const counted{};
+  CopyCounted::copies = 0;
+  // only the handler's result is a copy.
+  match(1)(pattern | _ = expr(counted));
+  EXPECT_EQ(CopyCounted::copies, 1);
+  auto const limit = 3;
+  static_assert(std::is_same_v<decltype(_ < limit),
+                               impl::Unary<impl::Bound<impl::Ref<int32_t const>, std::less<>, true>>>);
+  static_assert(std::is_same_v<decltype(_ < 3),
+                               impl::Unary<impl::Bound<int32_t, std::less<>, true>>>);
+}
+
+TEST(Expr, boundsReferToLvalues)
+{
+  auto limit = 3;
+  auto const below = matcher(
+      // clang-format off
+      pattern | (_ < limit)            = expr(0),
+      pattern | (limit <= _ && _ < 10) = expr(1),
+      pattern | (_ + 0 < 20)           = expr(2),
+      pattern | _                      = expr(3)
+      // clang-format on
+  );
+  EXPECT_EQ(below(5), 1);
+  limit = 6;
+  EXPECT_EQ(below(5), 0);
+  EXPECT_EQ(below(6), 1);
+  EXPECT_EQ(below(12), 2);
+}
@@ -1,6 +1,10 @@
 #include "matchit.h"
 #include <gtest/gtest.h>
+#include <array>
 #include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
 using namespace matchit;
 
 TEST(Id, matchValue)
@@ -160,6 +164,16 @@ TEST(Id, matchMultipleTimes3)
   EXPECT_EQ(result, 10);
 }
 
+TEST(Id, boundAfterMatch)
+{
+  Id<int32_t> x;
+  match(5)(pattern | x = [] {});
+  EXPECT_EQ(*x, 5);
+  // a bound Id matches only its value.
+  EXPECT_FALSE(matched(6, x));
+  EXPECT_TRUE(matched(5, x));
+}
+
 TEST(Id, AppToId)
 {
   Id<int32_t> ii;
@@ -239,13 +253,23 @@ TEST(Id, AppToId5PlusProNegative)
   auto const invalidMove = []
   {
     Id<std::unique_ptr<int32_t>> ii, jj;
-    match(std::make_unique<int32_t>(11))(
+    auto const p = std::make_unique<int32_t>(11);
+    match(p)(
         pattern | and_(ii, jj) = [&]
         { return jj.move(); });
   };
   EXPECT_THROW(invalidMove(), std::logic_error);
 }
 
+TEST(Id, moveFromRvalueSubject)
+{
+  Id<std::unique_ptr<int32_t>> ii, jj;
+  auto const result = match(std::make_unique<int32_t>(11))(
+      pattern | and_(ii, jj) = [&]
+      { return jj.move(); });
+  EXPECT_EQ(*result, 11);
+}
+
 TEST(Id, AppToId6)
 {
   Id<std::unique_ptr<int32_t>> ii;
@@ -309,3 +333,154 @@ TEST(Id, invalidMove)
   x.matchValue(str);
   EXPECT_THROW(x.move(), std::logic_error);
 }
+
+struct Big
+{
+  std::array<int32_t, 64> data{};
+  bool operator==(Big const &other) const { return data == other.data; }
+};
+
+static_assert(sizeof(Id<Big, ByRef>) == sizeof(Id<char, ByRef>));
+static_assert(sizeof(Id<Big, ByRef>) <= 3 * sizeof(void *));
+static_assert(sizeof(Id<Big, ByValue>) > sizeof(Big));
+static_assert(sizeof(Id<Big>) == sizeof(Id<Big, ByValue>));
+
+TEST(Id, storagePolicies)
+{
+  RecordProperty("sizeof(Big)", static_cast<int32_t>(sizeof(Big)));
+  RecordProperty("sizeof(Id<Big, ByRef>)", static_cast<int32_t>(sizeof(Id<Big, ByRef>)));
+  RecordProperty("sizeof(Id<Big, ByValue>)", static_cast<int32_t>(sizeof(Id<Big, ByValue>)));
+  RecordProperty("sizeof(Id<Big, Auto>)", static_cast<int32_t>(sizeof(Id<Big, Auto>)));
+
+  auto const big = Big{};
+  Id<Big, ByRef> r;
+  Id<Big, ByValue> v;
+  Id<Big, Auto> a;
+  EXPECT_TRUE(match(big)(pattern | and_(r, v, a) = expr(true), pattern | _ = expr(false)));
+  r.matchValue(big);
+  v.matchValue(big);
+  a.matchValue(big);
+  EXPECT_EQ(&*r, &big);
+  EXPECT_NE(&*v, &big);
+  EXPECT_EQ(&*a, &big);
+  EXPECT_THROW(r.move(), std::logic_error);
+}
+
+TEST(Id, byRefInPatterns)
+{
+  auto const values = std::vector<std::optional<std::string>>{"a", std::nullopt};
+  Id<std::string, ByRef> s;
+  auto const first = match(values[0])(pattern | some(s) = [&] { return &*s; },
+                                      pattern | _ = expr(nullptr));
+  EXPECT_EQ(first, &*values[0]);
+  auto const pair = std::make_tuple(1, std::string{"b"});
+  Id<std::string, ByRef> t;
+  auto const second = match(pair)(pattern | ds(1, t) = [&] { return &*t; });
+  EXPECT_EQ(second, &std::get<1>(pair));
+}
+
+class Tracked
+{
+public:
+  static inline int32_t copies = 0;
+  explicit Tracked(std::string text) : mText{std::move(text)} {}
+  Tracked(Tracked const &other) : mText{other.mText} { ++copies; }
+  Tracked(Tracked &&other) noexcept : mText{std::move(other.mText)} {}
+  Tracked &operator=(Tracked const &) = delete;
+  Tracked &operator=(Tracked &&) = delete;
+  bool operator==(Tracked const &other) const { return mText == other.mText; }
+  std::string const &text() const { return mText; }
+
+private:
+  std::string mText;
+};
+
+TEST(Id, rvalueSubjectIsNotCopied)
+{
+  Tracked::copies = 0;
+  Id<Tracked> t;
+  auto const result = match(Tracked{"payload"})(pattern | t = expr(std::move(t)));
+  EXPECT_EQ(result.text(), "payload");
+  EXPECT_EQ(Tracked::copies, 0);
+}
+
+class Copyable
+{
+public:
+  static inline int32_t copies = 0;
+  Copyable() = default;
+  Copyable(Copyable const &) { ++copies; }
+  Copyable(Copyable &&) = default;
+  Copyable &operator=(Copyable const &) = default;
+  Copyable &operator=(Copyable &&) = default;
+  bool operator==(Copyable const &) const { return true; }
+};
+
+TEST(Id, autoCopiesOnlyWhatIsNotAnLvalue)
+{
+  Id<Copyable> c;
+  auto const byValue = [](Copyable const &copyable) { return copyable; };
+  auto const copyable = Copyable{};
+  Copyable::copies = 0;
+  match(copyable)(pattern | c = [] {});
+  EXPECT_EQ(Copyable::copies, 0);
+  // the projection returns a copy, which the Id moves into its storage.
+  match(copyable)(pattern | app(byValue, c) = [] {});
+  EXPECT_EQ(Copyable::copies, 1);
+}
+
+TEST(Id, readAfterMatchOnTemporary)
+{
+  auto const make = [] { return std::string(40, 's'); };
+  Id<std::string> s;
+  match(make())(pattern | s = [] { return 0; });
+  // s took the string over, reading it after the temporary is gone is fine under ASan.
+  EXPECT_EQ(*s, std::string(40, 's'));
+  Id<std::string> t;
+  Id<std::string, ByValue> u;
+  match(std::make_pair(std::string(40, 't'), std::string(40, 'u')))(
+      pattern | ds(t, u) = [] { return 0; });
+  EXPECT_EQ(*t, std::string(40, 't'));
+  EXPECT_EQ(*u, std::string(40, 'u'));
+}
+
+TEST(Id, failedArmKeepsRvalueSubject)
+{
+  Id<std::string> s, t;
+  auto const result = match(std::string(32, 'x'))(
+      pattern | s | when([&] { return (*s).size() == 3; }) = [&] { return s.move(); },
+      pattern | t = [&] { return t.move(); });
+  EXPECT_EQ(result, std::string(32, 'x'));
+}
+
+TEST(Id, lvaluesAmongSubjectsAreNotMovedFrom)
+{
+  auto a = std::string(40, 'a');
+  auto b = std::string(40, 'b');
+  Id<std::string> x, y;
+  EXPECT_THROW(match(a, b)(pattern | ds(x, _) = [&] { return x.move(); }), std::logic_error);
+  EXPECT_EQ(a, std::string(40, 'a'));
+  // an rvalue among them can be moved from.
+  auto const moved = match(a, std::move(b))(pattern | ds(_, y) = [&] { return y.move(); });
+  EXPECT_EQ(moved, std::string(40, 'b'));
+  EXPECT_EQ(a, std::string(40, 'a'));
+}
+
+struct Named
+{
+  std::string mName;
+};
+
+TEST(Id, projectedReferencesAreMovedFromOnlyInsideTheSubject)
+{
+  auto outside = std::string(40, 'o');
+  auto const elsewhere = [&outside](int32_t) -> std::string & { return outside; };
+  Id<std::string> s, t;
+  EXPECT_THROW(match(1)(pattern | app(elsewhere, s) = [&] { return s.move(); }),
+               std::logic_error);
+  EXPECT_EQ(outside, std::string(40, 'o'));
+  auto const name = [](Named &named) -> std::string & { return named.mName; };
+  auto const moved =
+      match(Named{std::string(40, 'n')})(pattern | app(name, t) = [&] { return t.move(); });
+  EXPECT_EQ(moved, std::string(40, 'n'));
+}
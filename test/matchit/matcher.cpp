@@ -0,0 +1,202 @@
+#include "matchit.h"
+#include <gtest/gtest.h>
+#include <optional>
+#include <string>
+#include <vector>
+using namespace matchit;
+
+constexpr auto classify = matcher(
+    // clang-format off
+    pattern | 0                     = expr(0),
+    pattern | (1 <= _ && _ <= 9)    = expr(1),
+    pattern | (_ % 2 == 0)          = expr(2),
+    pattern | _                     = expr(3)
+    // clang-format on
+);
+
+static_assert(classify(0) == 0);
+static_assert(classify(7) == 1);
+static_assert(classify(12) == 2);
+static_assert(classify(13) == 3);
+
+TEST(Matcher, reuse)
+{
+  auto const m = matcher(pattern | ds(1, _) = expr("one"),
+                         pattern | ds(_, "two") = expr("two"),
+                         pattern | _ = expr("other"));
+  EXPECT_STREQ(m(1, "x"), "one");
+  EXPECT_STREQ(m(2, "two"), "two");
+  EXPECT_STREQ(m(std::make_tuple(3, "three")), "other");
+}
+
+TEST(Matcher, statement)
+{
+  int32_t sum = 0;
+  auto const m = matcher(pattern | (_ > 2) = [&] { sum += 10; },
+                         pattern | _ = [&] { sum += 1; });
+  for (auto i : {1, 2, 3, 4})
+  {
+    m(i);
+  }
+  EXPECT_EQ(sum, 22);
+}
+
+auto makeParser()
+{
+  return matcher<Id<int32_t>, Id<std::string>>(
+      [](Id<int32_t, PerCall<>> &n, Id<std::string, PerCall<>> &s)
+      {
+        return matcher(
+            // clang-format off
+            pattern | ds(n, "x")    = [&n] { return std::to_string(*n * 2); },
+            pattern | ds(_, s)      = [&s] { return *s; }
+            // clang-format on
+        );
+      });
+}
+
+TEST(Matcher, ownsBindings)
+{
+  auto const parse = makeParser();
+  EXPECT_EQ(parse(4, std::string{"x"}), "8");
+  EXPECT_EQ(parse(4, std::string{"y"}), "y");
+  EXPECT_EQ(parse(5, std::string{"x"}), "10");
+}
+
+TEST(Matcher, bindingsAreResetAfterEachCall)
+{
+  static auto const m = matcher<Id<int32_t>>(
+      [](Id<int32_t, PerCall<>> &x)
+      {
+        return matcher(pattern | some(x) = [&x] { return *x; },
+                       pattern | none = expr(-1));
+      });
+  EXPECT_EQ(m(std::make_optional(1)), 1);
+  EXPECT_EQ(m(std::optional<int32_t>{}), -1);
+  EXPECT_EQ(m(std::make_optional(2)), 2);
+  auto const values = std::vector<std::optional<int32_t>>{3, 4};
+  EXPECT_EQ(m(values[0]), 3);
+  EXPECT_EQ(m(values[1]), 4);
+}
+
+TEST(Matcher, ownsTemporaryOperands)
+{
+  auto const m = matcher(
+      // clang-format off
+      pattern | (_ == std::string{"a"}) = expr(std::string{"first"}),
+      pattern | _                       = expr(std::string{"other"})
+      // clang-format on
+  );
+  EXPECT_EQ(m(std::string{"a"}), "first");
+  EXPECT_EQ(m(std::string{"b"}), "other");
+}
+
+class CountedPred
+{
+public:
+  static inline int32_t copies = 0;
+  CountedPred() = default;
+  CountedPred(CountedPred const &) { ++copies; }
+  CountedPred &operator=(CountedPred const &) = default;
+  bool operator()(int32_t value) const { return value > 0; }
+};
+
+TEST(Matcher, buildsItsArmsOnce)
+{
+  auto const m = matcher<Id<int32_t>>(
+      [](Id<int32_t, PerCall<>> &x)
+      {
+        return matcher(pattern | and_(meet(CountedPred{}), x) = [&x] { return *x; },
+                       pattern | _ = expr(0));
+      });
+  CountedPred::copies = 0;
+  EXPECT_EQ(m(3), 3);
+  EXPECT_EQ(m(-3), 0);
+  EXPECT_EQ(m(5), 5);
+  EXPECT_EQ(CountedPred::copies, 0);
+}
+
+int32_t sumDown(std::optional<int32_t> const &n);
+
+auto const kSumDown = matcher<Id<int32_t>>(
+    [](Id<int32_t, PerCall<>> &x)
+    {
+      return matcher(
+          // clang-format off
+          pattern | some(x) = [&x]
+          {
+            auto const rest = *x > 0 ? sumDown(*x - 1) : 0;
+            return *x + rest;
+          },
+          pattern | none    = expr(0)
+          // clang-format on
+      );
+    });
+
+int32_t sumDown(std::optional<int32_t> const &n) { return kSumDown(n); }
+
+TEST(Matcher, nestedCallsHaveTheirOwnBindings)
+{
+  EXPECT_EQ(sumDown(3), 6);
+}
+
+TEST(MatchAll, writesResults)
+{
+  auto const values = std::vector<int32_t>{3, 0, 7, 150, -1, 200};
+  auto results = std::vector<int32_t>(values.size());
+  auto const end = matchAll(values, results.begin(),
+                            // clang-format off
+                            pattern | (_ < 0)              = expr(-1),
+                            pattern | (0 <= _ && _ < 100)  = expr(0),
+                            pattern | (100 <= _ && _ < 200)= expr(1),
+                            pattern | _                    = expr(2)
+                            // clang-format on
+  );
+  EXPECT_EQ(end, results.end());
+  EXPECT_EQ(results, (std::vector<int32_t>{0, 0, 0, 1, -1, 2}));
+}
+
+TEST(MatchAll, moreThanOneBlock)
+{
+  auto values = std::vector<int32_t>(1000);
+  for (std::size_t i = 0; i < values.size(); ++i)
+  {
+    values[i] = static_cast<int32_t>(i % 5);
+  }
+  auto results = std::vector<char>(values.size());
+  matchAll(values, results.data(),
+           // clang-format off
+           pattern | 0 = expr('a'),
+           pattern | 1 = expr('b'),
+           pattern | 2 = expr('c'),
+           pattern | _ = expr('z')
+           // clang-format on
+  );
+  EXPECT_EQ(results[0], 'a');
+  EXPECT_EQ(results[501], 'b');
+  EXPECT_EQ(results[999], 'z');
+}
+
+TEST(MatchAll, statementsAndBindings)
+{
+  auto const values = std::vector<std::optional<int32_t>>{1, std::nullopt, 3};
+  int32_t sum = 0;
+  int32_t nones = 0;
+  Id<int32_t> x;
+  matchAll(values,
+           // clang-format off
+           pattern | some(x) = [&] { sum += *x; },
+           pattern | none    = [&] { ++nones; }
+           // clang-format on
+  );
+  EXPECT_EQ(sum, 4);
+  EXPECT_EQ(nones, 1);
+}
+
+TEST(MatchAll, noMatch)
+{
+  auto const values = std::vector<int32_t>{1, 2};
+  auto results = std::vector<int32_t>(values.size());
+  EXPECT_THROW(matchAll(values, results.begin(), pattern | 1 = expr(1)),
+               std::logic_error);
+}
@@ -1,5 +1,8 @@
 #include "matchit.h"
 #include <gtest/gtest.h>
+#include <memory>
+#include <optional>
+#include <string>
 
 using namespace matchit;
 
@@ -20,4 +23,86 @@ TEST(MatchStatement, test)
 TEST(MatchExpreesion, Nomatch)
 {
   EXPECT_THROW(match(4)(pattern | 1 = expr(true)), std::logic_error);
-}
\ No newline at end of file
+}
+
+TEST(TryMatch, expression)
+{
+  auto const parity = [](int32_t i)
+  {
+    return tryMatch(i)(
+        // clang-format off
+        pattern | 0           = expr("zero"),
+        pattern | (_ % 2 == 1) = expr("odd")
+        // clang-format on
+    );
+  };
+  EXPECT_STREQ(parity(0).value(), "zero");
+  EXPECT_STREQ(parity(3).value(), "odd");
+  EXPECT_FALSE(parity(4).has_value());
+}
+
+TEST(TryMatch, statement)
+{
+  int32_t hits = 0;
+  EXPECT_TRUE(tryMatch(1, 2)(pattern | ds(1, _) = [&] { ++hits; }));
+  EXPECT_FALSE(tryMatch(2, 2)(pattern | ds(1, _) = [&] { ++hits; }));
+  EXPECT_EQ(hits, 1);
+}
+
+TEST(TryMatch, bindings)
+{
+  Id<std::string> s;
+  auto const result = tryMatch(std::make_optional(std::string{"text"}))(
+      pattern | some(s) = [&] { return *s + "!"; });
+  EXPECT_EQ(result, std::make_optional(std::string{"text!"}));
+}
+
+class Counted
+{
+public:
+  explicit Counted(int32_t value) : mValue{value} {}
+  Counted(Counted const &other) : mValue{other.mValue} { ++copies; }
+  Counted(Counted &&other) noexcept : mValue{other.mValue} { ++moves; }
+  Counted &operator=(Counted const &) = delete;
+  Counted &operator=(Counted &&) = delete;
+  int32_t value() const { return mValue; }
+  static inline int32_t copies = 0;
+  static inline int32_t moves = 0;
+
+private:
+  int32_t mValue;
+};
+
+TEST(MatchExpression, resultIsNotDefaultConstructed)
+{
+  Counted::copies = 0;
+  Counted::moves = 0;
+  auto const result = match(2)(
+      // clang-format off
+      pattern | 1 = [] { return Counted{1}; },
+      pattern | _ = [] { return Counted{2}; }
+      // clang-format on
+  );
+  EXPECT_EQ(result.value(), 2);
+  EXPECT_EQ(Counted::copies, 0);
+  EXPECT_LE(Counted::moves, 1);
+}
+
+TEST(MatchExpression, moveOnlyResult)
+{
+  auto const result = match(std::string{"ptr"})(
+      // clang-format off
+      pattern | "ptr" = [] { return std::make_unique<int32_t>(1); },
+      pattern | _     = [] { return std::unique_ptr<int32_t>{}; }
+      // clang-format on
+  );
+  ASSERT_NE(result, nullptr);
+  EXPECT_EQ(*result, 1);
+}
+
+TEST(MatchExpression, noMatchDestroysNothing)
+{
+  Counted::moves = 0;
+  EXPECT_THROW(match(3)(pattern | 1 = [] { return Counted{1}; }), std::logic_error);
+  EXPECT_EQ(Counted::moves, 0);
+}
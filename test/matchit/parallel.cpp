@@ -0,0 +1,73 @@
+#include "matchit.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+using namespace matchit;
+
+auto makeBucketer()
+{
+  return matcher<Id<int32_t>>(
+      [](Id<int32_t, PerCall<>> &x)
+      {
+        return matcher(
+            // clang-format off
+            pattern | (_ < 0)                       = expr(-1),
+            pattern | x.at(0 <= _ && _ < 10)        = [&x] { return *x; },
+            pattern | _                             = expr(10)
+            // clang-format on
+        );
+      });
+}
+
+TEST(ParallelMatchAll, sameAsSequential)
+{
+  auto values = std::vector<int32_t>(100'000);
+  for (std::size_t i = 0; i < values.size(); ++i)
+  {
+    values[i] = static_cast<int32_t>(i % 23) - 3;
+  }
+  auto expected = std::vector<int32_t>(values.size());
+  makeBucketer().all(values, expected.begin());
+  for (std::size_t nbThreads : {1U, 2U, 3U, 8U})
+  {
+    auto results = std::vector<int32_t>(values.size());
+    parallelMatchAll(values, results.begin(), makeBucketer, nbThreads);
+    EXPECT_EQ(results, expected);
+  }
+}
+
+TEST(ParallelMatchAll, emptyRange)
+{
+  auto const values = std::vector<int32_t>{};
+  auto results = std::vector<int32_t>{};
+  parallelMatchAll(values, results.begin(), makeBucketer, 4);
+  EXPECT_TRUE(results.empty());
+}
+
+TEST(ParallelMatchAll, noMatch)
+{
+  auto const values = std::vector<int32_t>(10'000, 1);
+  auto results = std::vector<int32_t>(values.size());
+  auto const makeMatcher = []
+  { return matcher(pattern | 0 = expr(0)); };
+  EXPECT_THROW(parallelMatchAll(values, results.data(), makeMatcher, 4), std::logic_error);
+}
+
+TEST(ParallelMatchAll, nested)
+{
+  // every worker of the outer call runs an inner one while building its matcher.
+  auto const inner = std::vector<int32_t>(3 * 4096, 5);
+  auto const makeCounter = [&inner]
+  {
+    auto results = std::vector<int32_t>(inner.size());
+    parallelMatchAll(inner, results.begin(), makeBucketer, 4);
+    auto const fives = std::count(results.begin(), results.end(), 5);
+    return matcher(pattern | _ = [fives] { return fives; });
+  };
+  auto const outer = std::vector<int32_t>(3 * 4096);
+  auto results = std::vector<std::ptrdiff_t>(outer.size());
+  parallelMatchAll(outer, results.begin(), makeCounter, 4);
+  EXPECT_EQ(results, std::vector<std::ptrdiff_t>(outer.size(), 3 * 4096));
+}
@@ -0,0 +1,142 @@
+#include "matchit.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+using namespace matchit;
+
+constexpr auto kKeyValue = regex("([a-z_]+)=(\\d+)");
+constexpr auto kVersion = regex("v(\\d+)\\.(\\d+)(?:\\.(\\d+))?");
+
+static_assert(kKeyValue.nbGroups() == 2);
+static_assert(matched(std::string_view{"port=80"}, kKeyValue()));
+static_assert(!matched(std::string_view{"port=x"}, kKeyValue()));
+static_assert(matched(std::string_view{"port=80"}, kKeyValue("port", "80")));
+static_assert(!matched(std::string_view{"port=80"}, kKeyValue("host")));
+
+TEST(Regex, captures)
+{
+  Id<std::string_view> key, value;
+  auto const line = std::string{"max_conn=128"};
+  auto const ok = match(line)(
+      pattern | kKeyValue(key, value) =
+          [&]
+      {
+        EXPECT_EQ(*key, "max_conn");
+        EXPECT_EQ(*value, "128");
+        EXPECT_EQ((*key).data(), line.data());
+        EXPECT_EQ((*value).data(), line.data() + 9);
+        return true;
+      },
+      pattern | _ = expr(false));
+  EXPECT_TRUE(ok);
+  // the whole string has to match.
+  EXPECT_FALSE(matched(std::string_view{"a=1;"}, kKeyValue(_, _)));
+  EXPECT_FALSE(matched(std::string_view{"=1"}, kKeyValue(_, _)));
+}
+
+TEST(Regex, optionalGroup)
+{
+  auto const version = [](std::string_view str)
+  {
+    Id<std::string_view> major, minor, patch;
+    return match(str)(
+        pattern | kVersion(major, minor, patch) =
+            [&] { return std::string{*major} + "|" + std::string{*minor} + "|" + std::string{*patch}; },
+        pattern | _ = expr(std::string{"none"}));
+  };
+  EXPECT_EQ(version("v1.22.3"), "1|22|3");
+  EXPECT_EQ(version("v1.22"), "1|22|");
+  EXPECT_EQ(version("v1."), "none");
+}
+
+TEST(Regex, alternationAndClasses)
+{
+  constexpr auto kMethod = regex("^(GET|POST|DELETE) (/[^ ?]*)(\\?.*)?$");
+  Id<std::string_view> method, path;
+  EXPECT_TRUE(matched(std::string_view{"GET /a/b"}, kMethod("GET", "/a/b")));
+  EXPECT_TRUE(matched(std::string_view{"DELETE /x?y=1"}, kMethod(method, path)));
+  EXPECT_FALSE(matched(std::string_view{"PUT /"}, kMethod(_)));
+  EXPECT_FALSE(matched(std::string_view{"GET a"}, kMethod(_)));
+
+  constexpr auto kWord = regex("[\\w-]+\\s*[^a-c\\]]");
+  EXPECT_TRUE(matched(std::string_view{"ab-c_9 \td"}, kWord()));
+  EXPECT_FALSE(matched(std::string_view{"ab b"}, kWord()));
+  EXPECT_FALSE(matched(std::string_view{"ab ]"}, kWord()));
+  EXPECT_TRUE(matched(std::string_view{"a.b"}, regex("a\\.b")()));
+  EXPECT_FALSE(matched(std::string_view{"axb"}, regex("a\\.b")()));
+  EXPECT_FALSE(matched(std::string_view{"a\nb"}, regex("a.b")()));
+}
+
+TEST(Regex, greedyAndLazy)
+{
+  Id<std::string_view> head, tail;
+  constexpr auto kGreedy = regex("(.*),(.*)");
+  constexpr auto kLazy = regex("(.*?),(.*)");
+  EXPECT_TRUE(matched(std::string_view{"a,b,c"}, kGreedy("a,b", "c")));
+  EXPECT_TRUE(matched(std::string_view{"a,b,c"}, kLazy("a", "b,c")));
+  // the last iteration of a repeated group is captured.
+  EXPECT_TRUE(matched(std::string_view{"abc"}, regex("(\\w)+")("c")));
+  EXPECT_TRUE(matched(std::string_view{""}, regex("(a)*")("")));
+}
+
+TEST(Regex, composition)
+{
+  constexpr auto kPair = regex("(\\d+),(\\d+)");
+  Id<std::string_view> lhs;
+  EXPECT_TRUE(matched(std::string_view{"12,12"}, kPair(lhs, lhs)));
+  EXPECT_FALSE(matched(std::string_view{"12,13"}, kPair(lhs, lhs)));
+  EXPECT_TRUE(matched(std::string_view{"12,34"},
+                      and_(kPair(or_(std::string_view{"21"}, std::string_view{"12"})), startsWith("1"))));
+  EXPECT_TRUE(matched(std::string_view{"7,8"}, kPair(_, regex("[0-9]")())));
+  auto const entries = std::array<std::string_view, 2>{"a=1", "b=2"};
+  EXPECT_TRUE(matched(entries, ds(kKeyValue("a"), kKeyValue(_, "2"))));
+}
+
+TEST(Regex, temporaryAutomaton)
+{
+  Id<std::string_view> key;
+  // the pattern keeps its own automaton once the temporary regex is gone.
+  auto const keyOnly = regex("([a-z]+)=1")(key);
+  EXPECT_TRUE(matched(std::string_view{"port=1"}, keyOnly));
+  EXPECT_FALSE(matched(std::string_view{"port=2"}, keyOnly));
+  auto const m = matcher(
+      // clang-format off
+      pattern | regex("([a-z]+)=1")(key) = [&] { return std::string{*key}; },
+      pattern | _                        = [] { return std::string{}; }
+      // clang-format on
+  );
+  EXPECT_EQ(m(std::string_view{"host=1"}), "host");
+  EXPECT_EQ(m(std::string_view{"host=2"}), "");
+}
+
+TEST(Regex, withoutDfa)
+{
+  // too many states for the DFA, the NFA is run instead.
+  constexpr auto kNthLast = regex("[ab]*a[ab][ab][ab][ab][ab][ab][ab][ab][ab]");
+  EXPECT_TRUE(matched(std::string_view{"bbbabbbbbbbbb"}, kNthLast()));
+  EXPECT_FALSE(matched(std::string_view{"bbbbabbbbbbbb"}, kNthLast()));
+}
+
+TEST(Regex, invalid)
+{
+  EXPECT_THROW(regex("a("), std::logic_error);
+  EXPECT_THROW(regex("a)"), std::logic_error);
+  EXPECT_THROW(regex("[a"), std::logic_error);
+  EXPECT_THROW(regex("*a"), std::logic_error);
+  EXPECT_THROW(regex("\\d{4}"), std::logic_error);
+  EXPECT_THROW(regex("a^"), std::logic_error);
+  EXPECT_THROW(regex("(a)")(_, _), std::logic_error);
+}
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+TEST(Regex, templateArgument)
+{
+  Id<std::string_view> user, host;
+  EXPECT_TRUE(matched(std::string_view{"me@example.org"},
+                      regex<"([^@]+)@([\\w.]+)">(user, host)));
+  EXPECT_TRUE(matched(std::string_view{"me@example.org"},
+                      regex<"([^@]+)@([\\w.]+)">("me", endsWith(".org"))));
+}
+#endif
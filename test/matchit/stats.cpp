@@ -0,0 +1,147 @@
+#include "matchit.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+using namespace matchit;
+
+TEST(MatchSite, countsAttemptsAndHits)
+{
+  static MatchSite site{"parity"};
+  auto const parity = [](int32_t i)
+  {
+    return match(i).at(site)(
+        // clang-format off
+        pattern | (_ % 2 == 0)  = expr("even"),
+        pattern | _             = expr("odd")
+        // clang-format on
+    );
+  };
+  for (auto i : {1, 2, 3, 5})
+  {
+    parity(i);
+  }
+  EXPECT_EQ(site.calls(), 4U);
+  ASSERT_EQ(site.nbArms(), 2U);
+  EXPECT_EQ(site.arm(0).mAttempts, 4U);
+  EXPECT_EQ(site.arm(0).mHits, 1U);
+  EXPECT_EQ(site.arm(0).mFailures, 3U);
+  EXPECT_EQ(site.arm(1).mAttempts, 3U);
+  EXPECT_EQ(site.arm(1).mHits, 3U);
+  EXPECT_EQ(site.arm(1).mFailures, 0U);
+}
+
+TEST(MatchSite, tableDispatchCountsHits)
+{
+  MatchSite site{"literals"};
+  for (auto i : {1, 2, 2, 7})
+  {
+    match(i).at(site)(
+        // clang-format off
+        pattern | 1 = [] {},
+        pattern | 2 = [] {},
+        pattern | _ = [] {}
+        // clang-format on
+    );
+  }
+  // the arms before the one found count as failed attempts.
+  EXPECT_EQ(site.arm(0).mAttempts, 4U);
+  EXPECT_EQ(site.arm(0).mHits, 1U);
+  EXPECT_EQ(site.arm(0).mFailures, 3U);
+  EXPECT_EQ(site.arm(1).mAttempts, 3U);
+  EXPECT_EQ(site.arm(1).mHits, 2U);
+  EXPECT_EQ(site.arm(1).mFailures, 1U);
+  EXPECT_EQ(site.arm(2).mAttempts, 1U);
+  EXPECT_EQ(site.arm(2).mHits, 1U);
+  EXPECT_EQ(site.arm(2).mFailures, 0U);
+}
+
+TEST(MatchSite, stringDispatchCountsAttempts)
+{
+  MatchSite site{"strings"};
+  for (auto s : {"b", "x", "a"})
+  {
+    match(std::string_view{s}).at(site)(
+        // clang-format off
+        pattern | "a" = [] {},
+        pattern | "b" = [] {}
+        // clang-format on
+    );
+  }
+  EXPECT_EQ(site.arm(0).mAttempts, 3U);
+  EXPECT_EQ(site.arm(0).mHits, 1U);
+  EXPECT_EQ(site.arm(0).mFailures, 2U);
+  EXPECT_EQ(site.arm(1).mAttempts, 2U);
+  EXPECT_EQ(site.arm(1).mHits, 1U);
+  EXPECT_EQ(site.arm(1).mFailures, 1U);
+}
+
+TEST(MatchSite, variantDispatchCountsAttempts)
+{
+  MatchSite site{"variant"};
+  using V = std::variant<int32_t, std::string>;
+  for (auto const &v : {V{1}, V{std::string{"a"}}, V{2}})
+  {
+    match(v).at(site)(
+        // clang-format off
+        pattern | as<int32_t>(_)     = [] {},
+        pattern | as<std::string>(_) = [] {}
+        // clang-format on
+    );
+  }
+  EXPECT_EQ(site.arm(0).mAttempts, 3U);
+  EXPECT_EQ(site.arm(0).mHits, 2U);
+  EXPECT_EQ(site.arm(0).mFailures, 1U);
+  EXPECT_EQ(site.arm(1).mAttempts, 1U);
+  EXPECT_EQ(site.arm(1).mHits, 1U);
+  EXPECT_EQ(site.arm(1).mFailures, 0U);
+}
+
+template <std::size_t... I>
+int32_t matchManyArms(MatchSite &site, int32_t i, std::index_sequence<I...>)
+{
+  return match(i).at(site)((pattern | (_ == static_cast<int32_t>(I)) = expr(1))...,
+                           pattern | _ = expr(0));
+}
+
+TEST(MatchSite, countsManyArms)
+{
+  MatchSite site{"many"};
+  EXPECT_EQ(matchManyArms(site, 98, std::make_index_sequence<99>{}), 1);
+  ASSERT_EQ(site.nbArms(), 100U);
+  EXPECT_EQ(site.arm(98).mAttempts, 1U);
+  EXPECT_EQ(site.arm(99).mAttempts, 0U);
+  EXPECT_EQ(site.arm(0).mFailures, 1U);
+}
+
+TEST(MatchSite, dump)
+{
+  MatchSite site{"dumped"};
+  match(1).at(site)(pattern | (_ % 2 == 1) = [] {});
+  std::ostringstream stream;
+  dumpMatchStats(stream);
+  EXPECT_NE(stream.str().find("match site dumped: 1 calls\n  arm 0: 1 attempts, 1 hits, 0 failures\n"),
+            std::string::npos);
+}
+
+TEST(MatchSite, tryMatchCountsAttempts)
+{
+  MatchSite site{"tryMatch"};
+  for (auto i : {1, 2, 3})
+  {
+    tryMatch(i).at(site)(pattern | (_ % 2 == 0) = expr(true));
+  }
+  EXPECT_EQ(site.calls(), 3U);
+  EXPECT_EQ(site.arm(0).mAttempts, 3U);
+  EXPECT_EQ(site.arm(0).mHits, 1U);
+  EXPECT_EQ(site.arm(0).mFailures, 2U);
+}
+
+TEST(MatchSite, unnamedMatchIsNotCounted)
+{
+  MatchSite site{"untouched"};
+  EXPECT_EQ(match(1)(pattern | _ = expr(1)), 1);
+  EXPECT_EQ(site.calls(), 0U);
+}
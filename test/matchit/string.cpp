@@ -0,0 +1,85 @@
+#include "matchit.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+using namespace matchit;
+
+static_assert(matched(std::string_view{"GET /index"}, startsWith("GET ")));
+static_assert(!matched(std::string_view{"GE"}, startsWith("GET ")));
+static_assert(matched(std::string_view{"a.json"}, endsWith(".json", "a")));
+static_assert(matched(std::string_view{"k=v"}, splitAt('=', "k", "v")));
+
+TEST(String, startsWith)
+{
+  auto const request = std::string{"GET /index.html"};
+  Id<std::string_view> path;
+  auto const result = match(request)(
+      pattern | startsWith("GET ", path)  = [&] { return *path; },
+      pattern | startsWith("POST ")       = expr(std::string_view{"post"}),
+      pattern | _                         = expr(std::string_view{}));
+  EXPECT_EQ(result, "/index.html");
+  EXPECT_EQ(result.data(), request.data() + 4);
+  EXPECT_FALSE(matched(std::string{"GE"}, startsWith("GET ")));
+  EXPECT_TRUE(matched("POST /", startsWith("POST ", "/")));
+}
+
+TEST(String, endsWith)
+{
+  Id<std::string_view> stem;
+  auto const file = std::string_view{"config.json"};
+  auto const result = match(file)(
+      pattern | endsWith(".json", stem) = [&] { return *stem; },
+      pattern | _                       = expr(std::string_view{}));
+  EXPECT_EQ(result, "config");
+  EXPECT_EQ(result.data(), file.data());
+  EXPECT_TRUE(matched(file, endsWith("config.json", "")));
+  EXPECT_FALSE(matched(file, endsWith(".yaml")));
+}
+
+TEST(String, splitAt)
+{
+  Id<std::string_view> key, value;
+  auto const header = std::string{"Content-Type: text/html"};
+  auto const ok = match(header)(
+      pattern | splitAt(": ", key, value) =
+          [&]
+      {
+        EXPECT_EQ(*key, "Content-Type");
+        EXPECT_EQ(*value, "text/html");
+        EXPECT_EQ((*value).data(), header.data() + 14);
+        return true;
+      },
+      pattern | _ = expr(false));
+  EXPECT_TRUE(ok);
+  EXPECT_FALSE(matched(header, splitAt('=', _, _)));
+  // the first separator splits.
+  EXPECT_TRUE(matched(std::string_view{"a b c"}, splitAt(' ', "a", "b c")));
+  EXPECT_TRUE(matched(std::string_view{"a b c"}, splitAt(' ', _, splitAt(' ', "b", "c"))));
+}
+
+TEST(String, sameIdOnBothSides)
+{
+  Id<std::string_view> side;
+  EXPECT_TRUE(matched(std::string_view{"ab|ab"}, splitAt('|', side, side)));
+  EXPECT_FALSE(matched(std::string_view{"ab|ba"}, splitAt('|', side, side)));
+}
+
+TEST(String, charBuffers)
+{
+  char method[8] = "GET ";
+  char separator[4] = ": ";
+  char value[8] = "v";
+  auto const request = std::string_view{"GET /"};
+  auto const startsWithMethod = startsWith(method);
+  EXPECT_TRUE(matched(request, startsWithMethod));
+  // buffers are read when matching.
+  method[0] = 'P';
+  EXPECT_FALSE(matched(request, startsWithMethod));
+  EXPECT_TRUE(matched(std::string_view{"PET /"}, startsWithMethod));
+  EXPECT_TRUE(matched(std::string_view{"a.v"}, startsWith("a.", value)));
+  EXPECT_TRUE(matched(std::string_view{"v.a"}, endsWith(".a", value)));
+  EXPECT_TRUE(matched(std::string_view{"k: v"}, splitAt(separator, "k", value)));
+  EXPECT_FALSE(matched(std::string_view{"k:v"}, splitAt(separator, "k", value)));
+  char const constSeparator[8] = ": ";
+  EXPECT_TRUE(matched(std::string_view{"k: v"}, splitAt(constSeparator, "k", "v")));
+}